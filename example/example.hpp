@@ -7,16 +7,18 @@ public:
     SimpleSum() {
         setTitle("Simple sum");
         setStyle(ImFlow::NodeStyle::green());
-        ImFlow::BaseNode::addIN<int>("In", 0, ImFlow::ConnectionFilter::SameType());
-        ImFlow::BaseNode::addOUT<int>("Out", nullptr)->behaviour([this]() { return getInVal<int>("In") + m_valB; });
+        m_in = ImFlow::BaseNode::addIN<int>("In", 0, ImFlow::ConnectionFilter::SameType());
+        ImFlow::BaseNode::addOUT<int>("Out", nullptr)->behaviour([this]() { return getInVal(m_in) + m_valB; });
     }
 
     void draw() override {
-        ImGui::SetNextItemWidth(100.f);
-        ImGui::InputInt("##ValB", &m_valB);
+        ImGui::SetNextItemWidth(100.f * getHandler()->getDrawScale());
+        if (ImGui::InputInt("##ValB", &m_valB))
+            markDirty();
     }
 
 private:
+    ImFlow::InPinHandle<int> m_in;
     int m_valB = 0;
 };
 
@@ -25,9 +27,9 @@ public:
     CollapsingNode() {
         setTitle("Collapsing node");
         setStyle(ImFlow::NodeStyle::red());
-        ImFlow::BaseNode::addIN<int>("A", 0, ImFlow::ConnectionFilter::SameType());
-        ImFlow::BaseNode::addIN<int>("B", 0, ImFlow::ConnectionFilter::SameType());
-        ImFlow::BaseNode::addOUT<int>("Out", nullptr)->behaviour([this]() { return getInVal<int>("A") + getInVal<int>("B"); });
+        m_a = ImFlow::BaseNode::addIN<int>("A", 0, ImFlow::ConnectionFilter::SameType());
+        m_b = ImFlow::BaseNode::addIN<int>("B", 0, ImFlow::ConnectionFilter::SameType());
+        ImFlow::BaseNode::addOUT<int>("Out", nullptr)->behaviour([this]() { return getInVal(m_a) + getInVal(m_b); });
     }
 
     void draw() override {
@@ -37,6 +39,8 @@ public:
         }
     }
 
+private:
+    ImFlow::InPinHandle<int> m_a, m_b;
 };
 
 class ResultNode : public ImFlow::BaseNode {
@@ -44,14 +48,16 @@ public:
     ResultNode() {
         setTitle("Result node");
         setStyle(ImFlow::NodeStyle::brown());
-        ImFlow::BaseNode::addIN<int>("A", 0, ImFlow::ConnectionFilter::SameType());
-        ImFlow::BaseNode::addIN<int>("B", 0, ImFlow::ConnectionFilter::SameType());
+        m_a = ImFlow::BaseNode::addIN<int>("A", 0, ImFlow::ConnectionFilter::SameType());
+        m_b = ImFlow::BaseNode::addIN<int>("B", 0, ImFlow::ConnectionFilter::SameType());
     }
 
     void draw() override {
-        ImGui::Text("Result: %d", getInVal<int>("A") + getInVal<int>("B"));
+        ImGui::Text("Result: %d", getInVal(m_a) + getInVal(m_b));
     }
 
+private:
+    ImFlow::InPinHandle<int> m_a, m_b;
 };
 
 
@@ -61,6 +67,8 @@ struct NodeEditor : ImFlow::BaseNode {
 
     NodeEditor(float d, std::size_t r) : BaseNode() {
         mINF.setSize({d, d});
+        // Drawn straight into the parent grid instead of stacking another context
+        mINF.directZoom(true);
         if (r > 0) {
             auto n1 = mINF.addNode<SimpleSum>({40, 40});
             auto n2 = mINF.addNode<SimpleSum>({40, 150});
@@ -8,13 +8,31 @@
 #include <vector>
 #include <cmath>
 #include <memory>
+#include <mutex>
 #include <algorithm>
 #include <functional>
+#include <future>
+#include <atomic>
+#include <chrono>
+#include <optional>
 #include <unordered_map>
+#include <unordered_set>
 #include <cstdint>
+#include <cstring>
+#include <exception>
+#include <type_traits>
+#include <stdexcept>
 #include <imgui.h>
 #include "../src/imgui_bezier_math.h"
 #include "../src/context_wrapper.h"
+#include "../src/work_stealing_pool.h"
+#include "../src/job_queue.h"
+#include "../src/stream.h"
+#include "../src/spatial_index.h"
+#include "../src/draw_cache.h"
+#include "../src/slot_map.h"
+#include "../src/memory_resource.h"
+#include "../src/style_registry.h"
 
 //#define ConnectionFilter_None       [](ImFlow::Pin* out, ImFlow::Pin* in){ return true; }
 //#define ConnectionFilter_SameType   [](ImFlow::Pin* out, ImFlow::Pin* in){ return out->getDataType() == in->getDataType(); }
@@ -25,6 +43,14 @@ namespace ImFlow
     // -----------------------------------------------------------------------------------------------------------------
     // HELPERS
 
+    /**
+     * @brief <BR>Get the control points of a sensible bezier between two points
+     * @param p1 Starting point
+     * @param p2 Ending point
+     * @return The four points of the cubic bezier drawn by smart_bezier
+     */
+    inline static ImCubicBezierPoints smart_bezier_points(const ImVec2& p1, const ImVec2& p2);
+
     /**
      * @brief <BR>Draw a sensible bezier between two points
      * @param p1 Starting point
@@ -61,6 +87,56 @@ namespace ImFlow
 
     typedef unsigned long long int PinUID;
 
+    /**
+     * @brief Immutable value shared by all the pins it flows to
+     * @details Pins carrying a snapshot only copy the pointer, useful for heavy values read by many nodes.
+     * @tparam T Type of the value
+     */
+    template<typename T> using Snapshot = std::shared_ptr<const T>;
+
+    /**
+     * @brief Whether values of a type can be compared with operator==
+     * @details Containers and pairs also need comparable elements, as their operator== doesn't check it before C++20.
+     * @tparam T Type of the values
+     */
+    template<typename T, typename = void>
+    struct IsComparable : std::false_type {};
+
+    template<typename T, typename = void>
+    struct ElementsComparable : std::true_type {};
+    template<typename T>
+    struct ElementsComparable<T, std::void_t<typename T::value_type>> : IsComparable<typename T::value_type> {};
+    template<typename A, typename B>
+    struct ElementsComparable<std::pair<A, B>> : std::conjunction<IsComparable<A>, IsComparable<B>> {};
+
+    template<typename T>
+    struct IsComparable<T, std::void_t<decltype(std::declval<const T&>() == std::declval<const T&>())>> : ElementsComparable<T> {};
+
+    /**
+     * @brief Typed handle of a static pin
+     * @details Position of the pin in its node's list, giving access to it without hashing nor scanning.
+     *          Built from the pointer returned by addIN() or addOUT(), dynamic pins have no valid handle.
+     *          Handles of pins moved by dropIN() or dropOUT() are resolved by UID instead, and handles of dropped pins are rejected.
+     * @tparam P Type of the pin, InPin<T> or OutPin<T>
+     */
+    template<typename P>
+    class PinHandle
+    {
+    public:
+        PinHandle() = default;
+        PinHandle(const std::shared_ptr<P>& pin);
+
+        [[nodiscard]] uint32_t index() const { return m_index; }
+        [[nodiscard]] PinUID uid() const { return m_uid; }
+        [[nodiscard]] bool valid() const { return m_index != UINT32_MAX; }
+    private:
+        uint32_t m_index = UINT32_MAX;
+        PinUID m_uid = 0;
+    };
+
+    template<typename T> using InPinHandle = PinHandle<InPin<T>>;
+    template<typename T> using OutPinHandle = PinHandle<OutPin<T>>;
+
     /**
      * @brief Extra pin's style setting
      */
@@ -119,24 +195,27 @@ namespace ImFlow
         /// @brief List of less common properties
         PinStyleExtras extra;
     public:
+        // Shared and immutable, see BaseNode::editStyle() and Pin::editStyle() to modify the style of one node or pin
+
         /// @brief <BR>Default cyan style
-        static std::shared_ptr<PinStyle> cyan() { return std::make_shared<PinStyle>(PinStyle(IM_COL32(87,155,185,255), 0, 4.f, 4.67f, 3.7f, 1.f)); }
+        static std::shared_ptr<const PinStyle> cyan() { static auto s = StyleRegistry<PinStyle>::intern(PinStyle(IM_COL32(87,155,185,255), 0, 4.f, 4.67f, 3.7f, 1.f)); return s; }
         /// @brief <BR>Default green style
-        static std::shared_ptr<PinStyle> green() { return std::make_shared<PinStyle>(PinStyle(IM_COL32(90,191,93,255), 4, 4.f, 4.67f, 4.2f, 1.3f)); }
+        static std::shared_ptr<const PinStyle> green() { static auto s = StyleRegistry<PinStyle>::intern(PinStyle(IM_COL32(90,191,93,255), 4, 4.f, 4.67f, 4.2f, 1.3f)); return s; }
         /// @brief <BR>Default blue style
-        static std::shared_ptr<PinStyle> blue() { return std::make_shared<PinStyle>(PinStyle(IM_COL32(90,117,191,255), 0, 4.f, 4.67f, 3.7f, 1.f)); }
+        static std::shared_ptr<const PinStyle> blue() { static auto s = StyleRegistry<PinStyle>::intern(PinStyle(IM_COL32(90,117,191,255), 0, 4.f, 4.67f, 3.7f, 1.f)); return s; }
         /// @brief <BR>Default brown style
-        static std::shared_ptr<PinStyle> brown() { return std::make_shared<PinStyle>(PinStyle(IM_COL32(191,134,90,255), 0, 4.f, 4.67f, 3.7f, 1.f)); }
+        static std::shared_ptr<const PinStyle> brown() { static auto s = StyleRegistry<PinStyle>::intern(PinStyle(IM_COL32(191,134,90,255), 0, 4.f, 4.67f, 3.7f, 1.f)); return s; }
         /// @brief <BR>Default red style
-        static std::shared_ptr<PinStyle> red() { return std::make_shared<PinStyle>(PinStyle(IM_COL32(191,90,90,255), 0, 4.f, 4.67f, 3.7f, 1.f)); }
+        static std::shared_ptr<const PinStyle> red() { static auto s = StyleRegistry<PinStyle>::intern(PinStyle(IM_COL32(191,90,90,255), 0, 4.f, 4.67f, 3.7f, 1.f)); return s; }
         /// @brief <BR>Default white style
-        static std::shared_ptr<PinStyle> white() { return std::make_shared<PinStyle>(PinStyle(IM_COL32(255,255,255,255), 5, 4.f, 4.67f, 4.2f, 1.f)); }
+        static std::shared_ptr<const PinStyle> white() { static auto s = StyleRegistry<PinStyle>::intern(PinStyle(IM_COL32(255,255,255,255), 5, 4.f, 4.67f, 4.2f, 1.f)); return s; }
     };
 
     // -----------------------------------------------------------------------------------------------------------------
     // NODE'S PROPERTIES
 
-    typedef uintptr_t NodeUID;
+    /// @brief Generational handle of a node in its editor, never 0
+    typedef uint64_t NodeUID;
 
     /**
      * @brief Defines the visual appearance of a node
@@ -166,14 +245,33 @@ namespace ImFlow
         /// @brief Border thickness when selected
         float border_selected_thickness = 2.f;
     public:
+        // Shared and immutable, see BaseNode::editStyle() and Pin::editStyle() to modify the style of one node or pin
+
         /// @brief <BR>Default cyan style
-        static std::shared_ptr<NodeStyle> cyan() { return std::make_shared<NodeStyle>(IM_COL32(71,142,173,255), ImColor(233,241,244,255), 6.5f); }
+        static std::shared_ptr<const NodeStyle> cyan() { static auto s = StyleRegistry<NodeStyle>::intern(NodeStyle(IM_COL32(71,142,173,255), ImColor(233,241,244,255), 6.5f)); return s; }
         /// @brief <BR>Default green style
-        static std::shared_ptr<NodeStyle> green() { return std::make_shared<NodeStyle>(IM_COL32(90,191,93,255), ImColor(233,241,244,255), 3.5f); }
+        static std::shared_ptr<const NodeStyle> green() { static auto s = StyleRegistry<NodeStyle>::intern(NodeStyle(IM_COL32(90,191,93,255), ImColor(233,241,244,255), 3.5f)); return s; }
         /// @brief <BR>Default red style
-        static std::shared_ptr<NodeStyle> red() { return std::make_shared<NodeStyle>(IM_COL32(191,90,90,255), ImColor(233,241,244,255), 11.f); }
+        static std::shared_ptr<const NodeStyle> red() { static auto s = StyleRegistry<NodeStyle>::intern(NodeStyle(IM_COL32(191,90,90,255), ImColor(233,241,244,255), 11.f)); return s; }
         /// @brief <BR>Default brown style
-        static std::shared_ptr<NodeStyle> brown() { return std::make_shared<NodeStyle>(IM_COL32(191,134,90,255), ImColor(233,241,244,255), 6.5f); }
+        static std::shared_ptr<const NodeStyle> brown() { static auto s = StyleRegistry<NodeStyle>::intern(NodeStyle(IM_COL32(191,134,90,255), ImColor(233,241,244,255), 6.5f)); return s; }
+    };
+
+    /**
+     * @brief Node's costs measured by the profiler during one frame
+     */
+    struct NodeProfileSample
+    {
+        /// @brief Profiler frame the sample belongs to
+        uint64_t frame = 0;
+        /// @brief Time spent in the node's behaviours, including the upstream nodes they pulled (ms)
+        double evalInclusive = 0.0;
+        /// @brief Time spent in the node's behaviours alone (ms)
+        double evalSelf = 0.0;
+        /// @brief Time spent drawing the node, excluding the evaluations it triggered (ms)
+        double draw = 0.0;
+        /// @brief Number of behaviours run
+        uint32_t calls = 0;
     };
 
     // -----------------------------------------------------------------------------------------------------------------
@@ -228,12 +326,40 @@ namespace ImFlow
          * @return [TRUE] If the link is selected in the current frame
          */
         [[nodiscard]] bool isSelected() const { return m_selected; }
+
+        /**
+         * @brief <BR>Set the Handler that contains the Link
+         * @param inf Pointer to the Handler, nullptr when the link outlives it
+         */
+        void setHandler(ImNodeFlow* inf) { m_inf = inf; }
     private:
+        /**
+         * @brief <BR>Rebuild the cached geometry if the shape of the link changed
+         * @details The geometry is stored relative to the starting point, so it only depends on the distance between the ends and the zoom.
+         * @param delta Ending point minus starting point
+         */
+        void updateGeometry(const ImVec2& delta);
+
+        /**
+         * @brief <BR>Draw the cached polyline
+         * @param start Starting point of the link
+         * @param color Color of the line
+         * @param thickness Thickness of the line
+         */
+        void strokeGeometry(const ImVec2& start, ImU32 color, float thickness);
+
         Pin* m_left;
         Pin* m_right;
         ImNodeFlow* m_inf;
         bool m_hovered = false;
         bool m_selected = false;
+
+        ImVec2 m_cacheDelta;
+        float m_cacheScale = 0.f;
+        bool m_cacheStraight = false;
+        ImCubicBezierPoints m_cacheCurve;
+        ImRect m_cacheBounds;
+        std::vector<ImVec2> m_cachePolyline;
     };
 
     // -----------------------------------------------------------------------------------------------------------------
@@ -250,6 +376,12 @@ namespace ImFlow
         ImU32 grid = IM_COL32(200, 200, 200, 40);
         /// @brief Secondary lines
         ImU32 subGrid = IM_COL32(200, 200, 200, 10);
+        /// @brief Sockets that can't accept the dragged link
+        ImU32 blockedPin = IM_COL32(110, 110, 110, 160);
+        /// @brief Ring around sockets whose background calculation failed
+        ImU32 errorPin = IM_COL32(230, 60, 50, 255);
+        /// @brief Header tint of the most expensive node in the profiler overlay
+        ImU32 profilerHot = IM_COL32(230, 50, 35, 255);
     };
 
     /**
@@ -261,6 +393,14 @@ namespace ImFlow
         float grid_size = 50.f;
         /// @brief Sub-grid divisions for Node snapping
         float grid_subdivisions = 5.f;
+        /// @brief Zoom below which nodes are drawn as plain boxes with their sockets (0 to disable, e.g. 0.5)
+        float lod_simplified_nodes = 0.f;
+        /// @brief Zoom below which links are drawn as straight lines (0 to disable, e.g. 0.4)
+        float lod_straight_links = 0.f;
+        /// @brief Zoom below which the sub-grid is hidden
+        float subgrid_fade_min = 0.55f;
+        /// @brief Zoom above which the sub-grid is fully visible, faded in between
+        float subgrid_fade_max = 0.85f;
         /// @brief ImNodeFlow colors
         InfColors colors;
     };
@@ -292,12 +432,74 @@ namespace ImFlow
             m_context.config().color = m_style.colors.background;
         }
 
+        /**
+         * @brief <BR>Detach the nodes still referenced elsewhere, so they stop calling back into the editor
+         */
+        ~ImNodeFlow();
+
         /**
          * @brief <BR>Handler loop
          * @details Main update function. Refreshes all the logic and draws everything. Must be called every frame.
          */
         void update();
 
+        /**
+         * @brief <BR>Evaluate the whole graph
+         * @details Resolves every output pin in a single linear pass following the topological order of the nodes.
+         *          The order is cached and only rebuilt when the graph's topology changes. Independent of update(),
+         *          calling it before update() makes the values pulled while drawing come straight from the cache.
+         */
+        void evaluate();
+
+        /**
+         * @brief <BR>Evaluate the given pins
+         * @details Resolves, in topological order, only the nodes the given pins depend on.
+         *          Doesn't require an ImGui context, so graphs can be evaluated headless (without ever calling update()).
+         * @param sinks Input or output pins to be evaluated
+         */
+        void evaluate(const std::vector<Pin*>& sinks);
+
+        /**
+         * @brief <BR>Evaluate the whole graph on multiple threads
+         * @details Nodes are scheduled on a work-stealing thread pool as soon as all the nodes feeding them are resolved.
+         *          Only nodes flagged as thread-safe run on worker threads, the others run on the calling thread.
+         *          Nodes on cycles are resolved afterwards on the calling thread.
+         *          If a behaviour throws, the nodes not started yet are skipped and the exception is rethrown here.
+         */
+        void evaluateParallel();
+
+        /**
+         * @brief <BR>Set number of threads used by evaluateParallel()
+         * @param count Number of threads, including the calling one. 0 to use all the hardware threads.
+         */
+        void setEvaluationThreads(unsigned count) { m_evalThreads = count; m_evalPool.reset(); }
+
+        /**
+         * @brief <BR>Set number of threads running asynchronous behaviours
+         * @details Jobs beyond that wait for a free thread. Takes effect once the running jobs are collected.
+         * @param count Number of background threads. 0 to use all the hardware threads.
+         */
+        void setBackgroundThreads(unsigned count) { std::lock_guard<std::mutex> lock(m_jobsMutex); m_jobThreads = count; }
+
+        /**
+         * @brief <BR>Run a job on one of the background threads
+         * @details Can be called from the workers of evaluateParallel().
+         * @param job Function to run, must not throw
+         */
+        void submitJob(std::function<void()> job);
+
+        /**
+         * @brief <BR>Collect the results of finished asynchronous behaviours
+         * @details Called by update() and by the evaluate functions.
+         */
+        void pollPendingJobs();
+
+        /**
+         * @brief <BR>Update the count of asynchronous behaviours running in the background
+         * @param count Number of jobs started (positive) or collected (negative)
+         */
+        void addPendingJobs(int count) { m_pendingJobs += count; }
+
         /**
          * @brief <BR>Add a node to the grid
          * @tparam T Derived class of <BaseNode> to be added
@@ -423,11 +625,78 @@ namespace ImFlow
          */
         ImVec2 getScreenSpaceDelta(){return m_context.getScreenDelta(); }
 
+        /**
+         * @brief <BR>Get the scale of sizes drawn in screen space
+         * @details 1 with the nested context (its output is scaled afterwards), the zoom in direct mode.
+         *          Custom renderers should multiply their sizes (radii, thicknesses, paddings) by it.
+         * @return Scale to apply to sizes expressed in grid units
+         */
+        [[nodiscard]] float getDrawScale() const { return m_context.drawScale(); }
+
         /**
          * @brief <BR>Get editor's list of nodes
-         * @return Const reference to editor's internal nodes list
+         * @details Iterates the nodes contiguously, in storage order (see getZOrder() for the drawing order).
+         * @return Const reference to editor's internal nodes storage
+         */
+        [[nodiscard]] const SlotMap<std::shared_ptr<BaseNode>>& getNodes() const { return m_nodes; }
+
+        /**
+         * @brief <BR>Get a node from its UID
+         * @param uid Unique identifier of the node
+         * @return Pointer to the node, nullptr if it was removed
+         */
+        BaseNode* getNode(NodeUID uid);
+
+        /**
+         * @brief <BR>Get the drawing order of the nodes
+         * @return UIDs of the nodes, back to front
+         */
+        const std::vector<NodeUID>& getZOrder() { return m_zOrder; }
+
+        /**
+         * @brief <BR>Draw a node on top of the others
+         * @details Applied at the end of the nodes update. Clicking a node brings it to the front.
+         * @param uid Unique identifier of the node
          */
-        std::unordered_map<NodeUID, std::shared_ptr<BaseNode>>& getNodes() { return m_nodes; }
+        void bringToFront(NodeUID uid);
+
+        /**
+         * @brief <BR>Remove a node right away
+         * @details Keeps the drawing order in sync. A node can't remove itself from its own draw(): use BaseNode::destroy(),
+         *          applied at the end of the nodes update.
+         * @param uid Unique identifier of the node
+         * @return [TRUE] if the node was found
+         */
+        bool removeNode(NodeUID uid);
+
+        /**
+         * @brief <BR>Remove every node and link
+         * @details Gives the memory of the resource back in bulk if nothing allocated from it is still referenced.
+         */
+        void clear();
+
+        /**
+         * @brief <BR>Set the source of the memory of nodes, pins and links
+         * @details Only affects the objects created afterwards, existing ones go back to the resource they came from.
+         *          Defaults to a counting resource forwarding to operator new. Use a PoolResource for large graphs:
+         *          @code inf.setMemoryResource(std::make_shared<ImFlow::PoolResource>()); @endcode
+         * @param resource New resource
+         */
+        void setMemoryResource(std::shared_ptr<MemoryResource> resource) { m_memory = std::move(resource); }
+
+        /**
+         * @brief <BR>Get the source of the memory of nodes, pins and links
+         * @return Shared pointer to the resource, see MemoryResource::counters() for the statistics
+         */
+        [[nodiscard]] const std::shared_ptr<MemoryResource>& getMemoryResource() const { return m_memory; }
+
+        /**
+         * @brief <BR>Get the memory used by the editor
+         * @details Nodes, pins and links are measured by the resource, so editors sharing one get the same figures.
+         *          Styles are counted once however many nodes and pins share them.
+         * @return Bytes used by each kind of object
+         */
+        [[nodiscard]] MemoryReport memoryReport();
 
         /**
          * @brief <BR>Get nodes count
@@ -512,18 +781,284 @@ namespace ImFlow
         bool on_free_space();
 
         /**
-         * @brief <BR>Get recursion blacklist for nodes
-         * @return Reference to blacklist
+         * @brief <BR>Get the nodes overlapping a rectangle
+         * @details Uses the spatial index, positions and sizes are the ones of the last update().
+         * @param min Top-left corner in grid coordinates
+         * @param max Bottom-right corner in grid coordinates
+         * @return List of the nodes overlapping the rectangle
+         */
+        std::vector<BaseNode*> getNodesInRect(const ImVec2& min, const ImVec2& max);
+
+        /**
+         * @brief <BR>Update a node's rectangle in the spatial index
+         * @param node Pointer to the node
+         * @param rect Rectangle covered by the node in grid coordinates
+         */
+        void indexNode(BaseNode* node, const ImRect& rect) { m_nodeIndex.update(node, rect); }
+
+        /**
+         * @brief <BR>Update a link's bounds in the spatial index
+         * @param link Pointer to the link
+         * @param rect Bounding rectangle of the link's hit-box in grid coordinates
+         */
+        void indexLink(Link* link, const ImRect& rect) { m_linkIndex.update(link, rect); }
+
+        /**
+         * @brief <BR>Remove a link from the spatial index
+         * @param link Pointer to the link
+         */
+        void unindexLink(Link* link) { m_linkIndex.remove(link); }
+
+        /**
+         * @brief <BR>Get current evaluation epoch
+         * @details Output pins run their behaviour at most once per epoch, this also breaks recursion on cyclic graphs.
+         *          The epoch advances at the end of each update().
+         * @return Current evaluation epoch
+         */
+        [[nodiscard]] uint64_t getEvaluationEpoch() const { return m_evalEpoch; }
+
+        /**
+         * @brief <BR>Set incremental evaluation
+         * @details When enabled, output pins only run their behaviour after being marked dirty (see BaseNode::markDirty()),
+         *          otherwise they return the cached value. Link changes mark the affected nodes automatically.
+         * @param state New state of the flag
+         */
+        void incrementalEvaluation(bool state);
+
+        /**
+         * @brief <BR>Get incremental evaluation status
+         * @return [TRUE] if incremental evaluation is enabled
+         */
+        [[nodiscard]] bool isIncremental() const { return m_incremental; }
+
+        /**
+         * @brief <BR>Discard the cached evaluation order
+         * @details Called when nodes, pins or links are added or removed. The order is rebuilt by the next evaluate().
+         */
+        void invalidateEvaluationPlan() { m_evalPlanValid = false; requestRedraw(); }
+
+        /**
+         * @brief <BR>Set cycle rejection
+         * @details When enabled, links that would close a cycle are refused on creation,
+         *          and while dragging a link the sockets it can't connect to are greyed out.
+         * @param state New state of the flag
+         */
+        void rejectCycles(bool state) { m_rejectCycles = state; }
+
+        /**
+         * @brief <BR>Get cycle rejection status
+         * @return [TRUE] if links closing a cycle are refused
+         */
+        [[nodiscard]] bool isRejectingCycles() const { return m_rejectCycles; }
+
+        /**
+         * @brief <BR>Check if linking two pins would create a cycle
+         * @details Uses the topological order of the nodes, so only the nodes between the two ends are visited.
+         *          Links between pins of the same node count as cycles, unless the input allows same node connections.
+         *          The link currently connected to the input is ignored, since the new one replaces it.
+         * @param out Output pin of the link
+         * @param in Input pin of the link
+         * @return [TRUE] if the link would close a cycle
+         */
+        bool wouldCreateCycle(Pin* out, Pin* in);
+
+        /**
+         * @brief <BR>Update the topological order after a new link
+         * @details Called by the input pins, reorders only the nodes between the two ends (Pearce-Kelly).
+         * @param from Node feeding the link
+         * @param to Node receiving the link
+         */
+        void linkTopologicalOrder(BaseNode* from, BaseNode* to);
+
+        /**
+         * @brief <BR>Check if a pin can't accept the link being dragged
+         * @param pin Pin to be tested
+         * @return [TRUE] if cycles are rejected and linking the pin to the dragged one would close a cycle
+         */
+        bool isLinkTargetBlocked(Pin* pin);
+
+        /**
+         * @brief <BR>Set profiler status
+         * @details When enabled, each node records its evaluation and drawing times for the last "frames" frames.
+         * @param state New state of the flag
+         * @param frames Number of frames kept by each node
+         */
+        void enableProfiler(bool state, unsigned frames = 120) { m_profiling = state; m_profilerFrames = frames ? frames : 1; }
+
+        /**
+         * @brief <BR>Get profiler status
+         * @return [TRUE] if the nodes' costs are being recorded
+         */
+        [[nodiscard]] bool isProfiling() const { return m_profiling; }
+
+        /**
+         * @brief <BR>Set profiler overlay
+         * @details When enabled, node headers are tinted by the cost of the node in the last frame.
+         * @param state New state of the flag
          */
-        std::vector<std::string>& get_recursion_blacklist() { return m_pinRecursionBlacklist; }
+        void profilerOverlay(bool state) { m_profilerOverlay = state; }
+
+        /**
+         * @brief <BR>Get profiler overlay status
+         * @return [TRUE] if node headers are tinted by cost
+         */
+        [[nodiscard]] bool isProfilerOverlay() const { return m_profilerOverlay; }
+
+        /**
+         * @brief <BR>Start a new profiler frame
+         * @details Called at the end of update(), must be called manually when evaluating headless.
+         */
+        void profilerNextFrame() { m_profilerFrame++; }
+
+        /**
+         * @brief <BR>Get current profiler frame
+         * @return Index of the frame being recorded
+         */
+        [[nodiscard]] uint64_t getProfilerFrame() const { return m_profilerFrame; }
+
+        /**
+         * @brief <BR>Get profiler history length
+         * @return Number of frames kept by each node
+         */
+        [[nodiscard]] unsigned getProfilerFrames() const { return m_profilerFrames; }
+
+        /**
+         * @brief <BR>Get highest node's cost of the last frame
+         * @details Updated by update() while the overlay is enabled.
+         * @return Self evaluation plus drawing time of the most expensive node (ms)
+         */
+        [[nodiscard]] double getProfilerMaxCost() const { return m_profilerMaxCost; }
+
+        /**
+         * @brief <BR>Set viewport culling
+         * @details When enabled, nodes outside of the visible part of the grid skip layout and rendering (and so draw()).
+         *          Selected and dragged nodes are always updated.
+         * @param state New state of the flag
+         */
+        void viewportCulling(bool state) { m_culling = state; }
+
+        /**
+         * @brief <BR>Get viewport culling status
+         * @return [TRUE] if off-screen nodes are culled
+         */
+        [[nodiscard]] bool isViewportCulling() const { return m_culling; }
+
+        /**
+         * @brief <BR>Set retained drawing of node backgrounds
+         * @details When enabled, each node keeps the geometry of its background, header and border
+         *          and replays it while its size, style, selection and zoom don't change.
+         * @param state New state of the flag
+         */
+        void nodeDrawCache(bool state) { m_nodeDrawCache = state; }
+
+        /**
+         * @brief <BR>Get retained drawing status
+         * @return [TRUE] if node backgrounds are replayed from their cache
+         */
+        [[nodiscard]] bool isNodeDrawCache() const { return m_nodeDrawCache; }
+
+        /**
+         * @brief <BR>Set retained drawing of the grid
+         * @details The grid lines repeat every grid_size, so they are generated once per zoom and window size
+         *          and only moved while scrolling. When disabled they are generated every frame.
+         * @param state New state of the flag
+         */
+        void gridDrawCache(bool state) { m_gridDrawCache = state; }
+
+        /**
+         * @brief <BR>Get retained grid drawing status
+         * @return [TRUE] if the grid is replayed from its cache
+         */
+        [[nodiscard]] bool isGridDrawCache() const { return m_gridDrawCache; }
+
+        /**
+         * @brief <BR>Set direct zoom mode
+         * @details When enabled, the grid is drawn straight into the current ImGui context with a scaled style and font,
+         *          instead of rendering a nested context and transforming its output.
+         *          Saves the second context, the copy of the input events and the rewrite of the vertices.
+         * @param state New state of the flag
+         */
+        void directZoom(bool state) { m_context.config().direct = state; }
+
+        /**
+         * @brief <BR>Get direct zoom mode status
+         * @return [TRUE] if the grid is drawn straight into the current context
+         */
+        [[nodiscard]] bool isDirectZoom() const { return m_context.config().direct; }
+
+        /**
+         * @brief <BR>Force the next frame to be fully processed
+         * @details Only matters when idle frames are skipped (see ContainedContextConfig::idle_skip).
+         *          Call it when something shown by the nodes changes without user input (e.g. a value updated from another thread).
+         */
+        void requestRedraw() { m_context.requestRedraw(); }
+
+        /**
+         * @brief <BR>Get whether the next frame will be fully processed
+         * @details Lets the application throttle its own frame rate while the editor is idle.
+         * @return [TRUE] if the editor changed recently, has pending input or is animating
+         */
+        [[nodiscard]] bool needsRedraw() const { return m_pendingJobs > 0 || m_context.needsRedraw(); }
     private:
         std::string m_name;
         ContainedContext m_context;
 
         bool m_singleUseClick = false;
 
-        std::unordered_map<NodeUID, std::shared_ptr<BaseNode>> m_nodes;
-        std::vector<std::string> m_pinRecursionBlacklist;
+        uint64_t m_evalEpoch = 1;
+        bool m_incremental = false;
+        std::vector<Pin*> m_evalPlan;
+        std::vector<BaseNode*> m_evalNodes;
+        std::unordered_map<BaseNode*, uint32_t> m_evalIndex;
+        std::vector<char> m_evalNeeded;
+        std::vector<uint32_t> m_evalDependencies;
+        std::vector<std::vector<uint32_t>> m_evalDownstream;
+        size_t m_evalAcyclic = 0;
+        bool m_evalPlanValid = false;
+        unsigned m_evalThreads = 0;
+        std::unique_ptr<WorkStealingPool> m_evalPool;
+        std::atomic<int> m_pendingJobs{0};
+        std::mutex m_jobsMutex;
+        unsigned m_jobThreads = 0;
+        std::unique_ptr<JobQueue> m_jobs;
+
+        bool m_rejectCycles = false;
+        bool m_topoValid = true;
+        uint32_t m_topoNext = 0;
+        std::vector<BaseNode*> m_topoForward, m_topoBackward;
+        std::unordered_set<BaseNode*> m_topoVisited;
+        std::unordered_set<BaseNode*> m_dragBlocked;
+
+        bool m_profiling = false;
+        bool m_profilerOverlay = false;
+        unsigned m_profilerFrames = 120;
+        uint64_t m_profilerFrame = 1;
+        double m_profilerMaxCost = 0.0;
+
+        bool m_culling = true;
+        bool m_nodeDrawCache = true;
+        bool m_gridDrawCache = true;
+
+        /**
+         * @brief Everything the grid pattern depends on, compared bytewise
+         */
+        struct GridCacheKey
+        {
+            ImVec2 size;
+            float step, subStep;
+            ImU32 grid, subGrid;
+            ImVec2 uvWhite;
+        };
+        DrawListCache m_gridCache;
+        GridCacheKey m_gridCacheKey{};
+
+        SpatialIndex<BaseNode*> m_nodeIndex;
+        SpatialIndex<Link*> m_linkIndex;
+
+        std::shared_ptr<MemoryResource> m_memory = std::make_shared<NewDeleteResource>();
+        SlotMap<std::shared_ptr<BaseNode>> m_nodes;
+        std::vector<NodeUID> m_zOrder;
+        std::vector<NodeUID> m_raised;
         std::vector<std::weak_ptr<Link>> m_links;
 
         std::function<void(Pin* dragged)> m_droppedLinkPopUp;
@@ -538,6 +1073,47 @@ namespace ImFlow
         Pin* m_dragOut = nullptr;
 
         InfStyler m_style;
+
+        /**
+         * @brief <BR>Sort the nodes and their output pins in topological order
+         */
+        void buildEvaluationPlan();
+
+        /**
+         * @brief <BR>Draw the grid lines, or replay them from the cache
+         * @param draw_list Draw list of the grid's window
+         * @param pos Position of the window in screen coordinates
+         * @param size Size of the window
+         */
+        void drawGrid(ImDrawList* draw_list, const ImVec2& pos, const ImVec2& size);
+
+        /**
+         * @brief <BR>Move the nodes passed to bringToFront() at the end of the drawing order
+         */
+        void applyRaised();
+
+        /**
+         * @brief <BR>Detach the nodes and links, which may outlive the handler
+         */
+        void detachAll();
+
+        /**
+         * @brief <BR>Reassign the topological order from scratch
+         * @details Only succeeds if the graph is acyclic.
+         */
+        void rebuildTopologicalOrder();
+
+        /**
+         * @brief <BR>Collect the nodes reachable from "start" following the links
+         * @param start First node of the search
+         * @param downstream [TRUE] to follow the links forward, [FALSE] backward
+         * @param bound Only visit nodes with a topological order up to (forward) or from (backward) this value
+         * @param target Stop as soon as this node is reached
+         * @param found Nodes reached, in order of discovery
+         * @param skip Link not to follow
+         * @return [TRUE] if "target" was reached
+         */
+        bool collectReachable(BaseNode* start, bool downstream, uint32_t bound, BaseNode* target, std::vector<BaseNode*>& found, const Link* skip = nullptr);
     };
 
     // -----------------------------------------------------------------------------------------------------------------
@@ -550,7 +1126,7 @@ namespace ImFlow
     class BaseNode
     {
     public:
-        virtual ~BaseNode() = default;
+        virtual ~BaseNode();
         BaseNode() = default;
 
         /**
@@ -559,6 +1135,20 @@ namespace ImFlow
          */
         void update();
 
+        /**
+         * @brief <BR>Main loop of the node while outside of the viewport
+         * @details Skips layout and rendering, only moves the pins along with the node so links reaching it stay attached.
+         *          Dynamic pins are kept alive.
+         */
+        void updateCulled();
+
+        /**
+         * @brief <BR>Main loop of the node when zoomed out
+         * @details Draws the node as a box with its sockets, without text, widgets or calling draw().
+         *          Selecting, dragging and linking still work, dynamic pins are kept alive.
+         */
+        void updateSimplified();
+
         /**
          * @brief <BR>Content of the node
          * @details Function to be implemented by derived custom nodes.
@@ -579,7 +1169,7 @@ namespace ImFlow
          * @return Shared pointer to the newly added pin
          */
         template<typename T>
-        std::shared_ptr<InPin<T>> addIN(const std::string& name, T defReturn, std::function<bool(Pin*, Pin*)> filter, std::shared_ptr<PinStyle> style = nullptr);
+        std::shared_ptr<InPin<T>> addIN(const std::string& name, T defReturn, std::function<bool(Pin*, Pin*)> filter, std::shared_ptr<const PinStyle> style = nullptr);
 
         /**
          * @brief <BR>Add an Input to the node
@@ -595,7 +1185,7 @@ namespace ImFlow
          * @return Shared pointer to the newly added pin
          */
         template<typename T, typename U>
-        std::shared_ptr<InPin<T>> addIN_uid(const U& uid, const std::string& name, T defReturn, std::function<bool(Pin*, Pin*)> filter, std::shared_ptr<PinStyle> style = nullptr);
+        std::shared_ptr<InPin<T>> addIN_uid(const U& uid, const std::string& name, T defReturn, std::function<bool(Pin*, Pin*)> filter, std::shared_ptr<const PinStyle> style = nullptr);
 
         /**
          * @brief <BR>Remove input pin
@@ -625,7 +1215,7 @@ namespace ImFlow
          * @return Const reference to the value of the connected link for the current frame of defReturn
          */
         template<typename T>
-        const T& showIN(const std::string& name, T defReturn, std::function<bool(Pin*, Pin*)> filter, std::shared_ptr<PinStyle> style = nullptr);
+        const T& showIN(const std::string& name, T defReturn, std::function<bool(Pin*, Pin*)> filter, std::shared_ptr<const PinStyle> style = nullptr);
 
         /**
          * @brief <BR>Show a temporary input pin
@@ -642,7 +1232,7 @@ namespace ImFlow
          * @return Const reference to the value of the connected link for the current frame of defReturn
          */
         template<typename T, typename U>
-        const T& showIN_uid(const U& uid, const std::string& name, T defReturn, std::function<bool(Pin*, Pin*)> filter, std::shared_ptr<PinStyle> style = nullptr);
+        const T& showIN_uid(const U& uid, const std::string& name, T defReturn, std::function<bool(Pin*, Pin*)> filter, std::shared_ptr<const PinStyle> style = nullptr);
 
         /**
          * @brief <BR>Add an Output to the node
@@ -656,7 +1246,7 @@ namespace ImFlow
          * @return Shared pointer to the newly added pin. Must be used to set the behaviour
          */
         template<typename T>
-        [[nodiscard]] std::shared_ptr<OutPin<T>> addOUT(const std::string& name, std::shared_ptr<PinStyle> style = nullptr);
+        [[nodiscard]] std::shared_ptr<OutPin<T>> addOUT(const std::string& name, std::shared_ptr<const PinStyle> style = nullptr);
 
         /**
          * @brief <BR>Add an Output to the node
@@ -671,7 +1261,7 @@ namespace ImFlow
          * @return Shared pointer to the newly added pin. Must be used to set the behaviour
          */
         template<typename T, typename U>
-        [[nodiscard]] std::shared_ptr<OutPin<T>> addOUT_uid(const U& uid, const std::string& name, std::shared_ptr<PinStyle> style = nullptr);
+        [[nodiscard]] std::shared_ptr<OutPin<T>> addOUT_uid(const U& uid, const std::string& name, std::shared_ptr<const PinStyle> style = nullptr);
 
         /**
          * @brief <BR>Remove output pin
@@ -700,7 +1290,7 @@ namespace ImFlow
          * @param style Style of the pin
          */
         template<typename T>
-        void showOUT(const std::string& name, std::function<T()> behaviour, std::shared_ptr<PinStyle> style = nullptr);
+        void showOUT(const std::string& name, std::function<T()> behaviour, std::shared_ptr<const PinStyle> style = nullptr);
 
         /**
          * @brief <BR>Show a temporary output pin
@@ -716,7 +1306,7 @@ namespace ImFlow
          * @param style Style of the pin
          */
         template<typename T, typename U>
-        void showOUT_uid(const U& uid, const std::string& name, std::function<T()> behaviour, std::shared_ptr<PinStyle> style = nullptr);
+        void showOUT_uid(const U& uid, const std::string& name, std::function<T()> behaviour, std::shared_ptr<const PinStyle> style = nullptr);
 
         /**
          * @brief <BR>Get Input value from an InPin
@@ -739,6 +1329,35 @@ namespace ImFlow
         template<typename T>
         const T& getInVal(const char* uid);
 
+        /**
+         * @brief <BR>Get Input value from an InPin
+         * @details Same as the UID version in constant time.
+         * @tparam T Data type
+         * @param pin Handle of the pin
+         * @return Const reference to the value
+         * @throw std::out_of_range if the handle doesn't resolve to an input of the node
+         */
+        template<typename T>
+        const T& getInVal(InPinHandle<T> pin);
+
+        /**
+         * @brief <BR>Get typed reference to input pin
+         * @tparam T Data type
+         * @param pin Handle of the pin
+         * @return Pointer to the pin, nullptr if the handle doesn't resolve
+         */
+        template<typename T>
+        InPin<T>* inPin(InPinHandle<T> pin) { return pinAt(m_ins, pin); }
+
+        /**
+         * @brief <BR>Get typed reference to output pin
+         * @tparam T Data type
+         * @param pin Handle of the pin
+         * @return Pointer to the pin, nullptr if the handle doesn't resolve
+         */
+        template<typename T>
+        OutPin<T>* outPin(OutPinHandle<T> pin) { return pinAt(m_outs, pin); }
+
         /**
          * @brief <BR>Get generic reference to input pin
          * @tparam U Type of the UID
@@ -783,6 +1402,40 @@ namespace ImFlow
          */
         const std::vector<std::shared_ptr<Pin>>& getOuts() { return m_outs; }
 
+        /**
+         * @brief <BR>Get internal dynamic input pins list
+         * @details Each pin is paired with the generation it was last shown in.
+         * @return Const reference to node's internal list
+         */
+        const std::vector<std::pair<uint32_t, std::shared_ptr<Pin>>>& getDynamicIns() { return m_dynamicIns; }
+
+        /**
+         * @brief <BR>Get internal dynamic output pins list
+         * @details Each pin is paired with the generation it was last shown in.
+         * @return Const reference to node's internal list
+         */
+        const std::vector<std::pair<uint32_t, std::shared_ptr<Pin>>>& getDynamicOuts() { return m_dynamicOuts; }
+
+        /**
+         * @brief <BR>Mark node's outputs as dirty
+         * @details In incremental mode outputs are only re-evaluated after being marked dirty.
+         *          Dirtiness propagates to every node downstream. Call it when the node's internal state changes.
+         */
+        void markDirty();
+
+        /**
+         * @brief <BR>Mark node's outputs as dirty, as part of a propagation
+         * @param walk Identifier of the propagation, pins already reached by it are skipped
+         */
+        void propagateDirty(uint64_t walk);
+
+        /**
+         * @brief <BR>Redraw node's background next frame
+         * @details The background is replayed from the last frame while the size, style, selection and zoom are unchanged.
+         *          Call it when something else drawn in the background channel changes (see ImNodeFlow::nodeDrawCache()).
+         */
+        void invalidateDrawCache() { m_drawCache.invalidate(); }
+
         /**
          * @brief <BR>Delete itself
          */
@@ -837,9 +1490,16 @@ namespace ImFlow
 
         /**
          * @brief <BR>Get node's style
-         * @return Shared pointer to the node's style
+         * @return Shared pointer to the node's style, possibly shared with other nodes
+         */
+        const std::shared_ptr<const NodeStyle>& getStyle() { return m_style; }
+
+        /**
+         * @brief <BR>Get node's style for modification
+         * @details The style is copied on the first call after setStyle(), so the nodes sharing it aren't affected.
+         * @return Reference to the node's own style
          */
-        const std::shared_ptr<NodeStyle>& getStyle() { return m_style; }
+        NodeStyle& editStyle();
 
         /**
          * @brief <BR>Get selected status
@@ -853,6 +1513,40 @@ namespace ImFlow
          */
         [[nodiscard]] bool isDragged() const { return m_dragged; }
 
+        /**
+         * @brief <BR>Get thread-safe status
+         * @return [TRUE] if the behaviours of the node can run on a worker thread
+         */
+        [[nodiscard]] bool isThreadSafe() const { return m_threadSafe; }
+
+        /**
+         * @brief <BR>Get node's topological order
+         * @details Every node feeding this one has a smaller order. Maintained by the handler.
+         * @return Position of the node in the topological order
+         */
+        [[nodiscard]] uint32_t getTopologicalOrder() const { return m_topoOrder; }
+
+        /**
+         * @brief <BR>Get node's profiler sample
+         * @param age How many frames ago (up to getProfilerFrames()), 0 for the frame being recorded
+         * @return Copy of the sample, empty if nothing was recorded in that frame
+         */
+        [[nodiscard]] NodeProfileSample getProfile(unsigned age = 0) const;
+
+        /**
+         * @brief <BR>Get node's average profiler sample
+         * @details Averages all the completed frames kept by the profiler.
+         * @return Sample with the average costs
+         */
+        [[nodiscard]] NodeProfileSample getProfileAverage() const;
+
+        /**
+         * @brief <BR>Record the cost of a behaviour
+         * @param inclusive Time including the upstream evaluations it triggered (ms)
+         * @param self Time of the behaviour alone (ms)
+         */
+        void recordEvaluation(double inclusive, double self);
+
         /**
          * @brief <BR>Set node's uid
          * @param uid Node's unique identifier
@@ -881,7 +1575,22 @@ namespace ImFlow
          * @brief Set node's style
          * @param style New style
          */
-        BaseNode* setStyle(std::shared_ptr<NodeStyle> style) { m_style = std::move(style); return this; }
+        BaseNode* setStyle(std::shared_ptr<const NodeStyle> style) { m_style = std::move(style); m_ownStyle = false; return this; }
+
+        /**
+         * @brief <BR>Set thread-safe status
+         * @details Behaviours of thread-safe nodes can run on worker threads during ImNodeFlow::evaluateParallel().
+         *          They must only read the node's inputs and must not use ImGui.
+         * @param state New thread-safe state
+         */
+        BaseNode* setThreadSafe(bool state) { m_threadSafe = state; return this; }
+
+        /**
+         * @brief <BR>Set node's topological order
+         * @details Used by the handler, changing it manually breaks cycle detection.
+         * @param order New position of the node in the topological order
+         */
+        BaseNode* setTopologicalOrder(uint32_t order) { m_topoOrder = order; return this; }
 
         /**
          * @brief <BR>Set selected status
@@ -895,22 +1604,139 @@ namespace ImFlow
          * @brief <BR>Update the isSelected status of the node
          */
         void updatePublicStatus() { m_selected = m_selectedNext; }
+
+        /**
+         * @brief <BR>Get the sample of the frame being recorded
+         * @return Reference to the sample, cleared if it belonged to an older frame
+         */
+        NodeProfileSample& profileSample();
     private:
+        /**
+         * @brief <BR>Get the resource new pins are allocated from
+         * @return Resource of the handler, or the current one while the node is being built
+         */
+        [[nodiscard]] std::shared_ptr<MemoryResource> memoryResource() const;
+
+        /**
+         * @brief <BR>Resolve a pin handle
+         * @details Looks the UID up if the pin isn't at the handle's position anymore.
+         * @param pins List the handle points in
+         * @param pin Handle of the pin
+         * @return Pointer to the pin, nullptr if the handle isn't valid or the pin was dropped
+         */
+        template<typename P>
+        P* pinAt(const std::vector<std::shared_ptr<Pin>>& pins, PinHandle<P> pin);
+
+        /**
+         * @brief <BR>Find a dynamic pin and keep it alive for the current generation
+         * @param pins Dynamic pins list
+         * @param index UID to position map of the list
+         * @param uid Unique identifier of the pin
+         * @return Pointer to the pin, nullptr if it doesn't exist
+         */
+        Pin* showDynamic(std::vector<std::pair<uint32_t, std::shared_ptr<Pin>>>& pins, std::unordered_map<PinUID, uint32_t>& index, PinUID uid);
+
+        /**
+         * @brief <BR>Add a dynamic pin, alive for the current generation
+         * @param pins Dynamic pins list
+         * @param index UID to position map of the list
+         * @param pin New pin
+         */
+        void addDynamic(std::vector<std::pair<uint32_t, std::shared_ptr<Pin>>>& pins, std::unordered_map<PinUID, uint32_t>& index, std::shared_ptr<Pin> pin);
+
+        /**
+         * @brief <BR>Remove the dynamic pins not shown since the previous update and start a new generation
+         */
+        void pruneDynamicPins();
+
+        /**
+         * @brief <BR>Handle selection, deletion and dragging
+         * @param mouseClickState Click status at the beginning of the update
+         * @param handle Area used to drag the node, in screen coordinates
+         */
+        void updateInteractions(bool mouseClickState, const ImRect& handle);
+
+        /**
+         * @brief <BR>Get header color
+         * @return Header color from the style, tinted by the profiler overlay if enabled
+         */
+        ImU32 headerColor();
+
+        /**
+         * @brief <BR>Draw background, header and border, or replay them from the cache
+         * @param origin Position of the node in screen coordinates
+         * @param headerH Height of the header in grid units
+         */
+        void drawBackground(const ImVec2& origin, float headerH);
+
+        /**
+         * @brief Everything the background depends on, compared bytewise
+         */
+        struct DrawCacheKey
+        {
+            ImVec2 size;
+            float headerH, scale;
+            ImU32 header, bg, border;
+            float radius, thickness;
+            ImVec4 padding;
+            ImVec2 uvWhite;
+        };
+
         NodeUID m_uid = 0;
         std::string m_title;
         ImVec2 m_pos, m_posTarget;
         ImVec2 m_size;
         ImVec2 m_fullSize;
+        ImVec2 m_dynamicInsSize;
+        ImVec2 m_drawOrigin;
+        float m_drawScale = 1.f;
+        DrawListCache m_drawCache;
+        DrawCacheKey m_drawCacheKey{};
         ImNodeFlow* m_inf = nullptr;
-        std::shared_ptr<NodeStyle> m_style;
+        std::shared_ptr<const NodeStyle> m_style;
+        bool m_ownStyle = false;
         bool m_selected = false, m_selectedNext = false;
         bool m_dragged = false;
         bool m_destroyed = false;
+        bool m_threadSafe = false;
+        uint32_t m_topoOrder = 0;
+        std::vector<NodeProfileSample> m_profile;
 
         std::vector<std::shared_ptr<Pin>> m_ins;
-        std::vector<std::pair<int, std::shared_ptr<Pin>>> m_dynamicIns;
+        std::vector<std::pair<uint32_t, std::shared_ptr<Pin>>> m_dynamicIns;
+        std::unordered_map<PinUID, uint32_t> m_dynamicInsIndex;
         std::vector<std::shared_ptr<Pin>> m_outs;
-        std::vector<std::pair<int, std::shared_ptr<Pin>>> m_dynamicOuts;
+        std::vector<std::pair<uint32_t, std::shared_ptr<Pin>>> m_dynamicOuts;
+        std::unordered_map<PinUID, uint32_t> m_dynamicOutsIndex;
+        uint32_t m_dynamicGeneration = 1;
+        size_t m_dynamicShown = 0;
+    };
+
+    // -----------------------------------------------------------------------------------------------------------------
+    // PROFILER
+
+    /**
+     * @brief Measures the time spent in its scope and records it to a node
+     * @details Nested scopes on the same thread are subtracted from the outer ones, giving the self time.
+     */
+    class ProfilerScope
+    {
+    public:
+        /**
+         * @brief <BR>Start measuring
+         * @param node Node the time is recorded to
+         * @param draw [TRUE] to record drawing time, [FALSE] for evaluation time
+         */
+        ProfilerScope(BaseNode* node, bool draw);
+        ~ProfilerScope();
+        ProfilerScope(const ProfilerScope&) = delete;
+        ProfilerScope& operator=(const ProfilerScope&) = delete;
+    private:
+        BaseNode* m_node;
+        bool m_draw;
+        double m_outerChildTime;
+        std::chrono::steady_clock::time_point m_start;
+        inline static thread_local double s_childTime = 0.0;
     };
 
     // -----------------------------------------------------------------------------------------------------------------
@@ -925,6 +1751,21 @@ namespace ImFlow
         PinType_Output
     };
 
+    /**
+     * @brief Pins value state
+     */
+    enum PinState
+    {
+        /// @brief Value is up-to-date
+        PinState_Ready,
+        /// @brief Value is being calculated in the background, no value produced yet
+        PinState_Pending,
+        /// @brief Value is being calculated in the background, previous value still in use
+        PinState_Stale,
+        /// @brief Last calculation in the background failed, previous value still in use
+        PinState_Error
+    };
+
     /**
      * @brief Generic base class for pins
      */
@@ -940,7 +1781,7 @@ namespace ImFlow
          * @param inf Pointer to the Grid Handler the pin is in (same as parent)
          * @param style Style of the pin
          */
-        explicit Pin(PinUID uid, std::string name, std::shared_ptr<PinStyle> style, PinType kind, BaseNode* parent, ImNodeFlow** inf)
+        explicit Pin(PinUID uid, std::string name, std::shared_ptr<const PinStyle> style, PinType kind, BaseNode* parent, ImNodeFlow** inf)
             :m_uid(uid), m_name(std::move(name)), m_type(kind), m_parent(parent), m_inf(inf), m_style(std::move(style))
             {
                 if(!m_style)
@@ -970,6 +1811,48 @@ namespace ImFlow
          */
         virtual void resolve() {}
 
+        /**
+         * @brief <BR>Mark the pin's value as outdated
+         * @details Used by output pins to propagate dirtiness to the connected nodes
+         */
+        void markDirty() { propagateDirty(newDirtyWalk()); }
+
+        /**
+         * @brief <BR>Mark the pin's value as outdated, as part of a propagation
+         * @param walk Identifier of the propagation, pins already reached by it are skipped
+         */
+        virtual void propagateDirty(uint64_t /*walk*/) {}
+
+        /**
+         * @brief <BR>Get the identifier of a new dirtiness propagation
+         * @return Identifier never returned before
+         */
+        static uint64_t newDirtyWalk() { static std::atomic<uint64_t> walk{0}; return ++walk; }
+
+        /**
+         * @brief <BR>Get the number of times an output pin went from dirty to clean, in any handler
+         * @details Dirtiness walks stop at pins reached since the last change: everything downstream of them is still dirty.
+         */
+        static std::atomic<uint64_t>& cleanCount() { static std::atomic<uint64_t> count{0}; return count; }
+
+        /**
+         * @brief <BR>Used by output pins to collect values calculated in the background
+         */
+        virtual void poll() {}
+
+        /**
+         * @brief <BR>Get pin's value state
+         * @return Whether the value is ready or still being calculated in the background
+         */
+        virtual PinState getState() { return PinState_Ready; }
+
+        /**
+         * @brief <BR>Get the version of the pin's value
+         * @details Output pins count the changes of their value, input pins forward the count of the connected output.
+         * @return Number changing whenever the value may have changed
+         */
+        virtual uint64_t getVersion() { return 0; }
+
         /**
          * @brief <BR>Custom render function to override Pin appearance
          * @param r Function or lambda expression with new ImGui rendering
@@ -1005,6 +1888,18 @@ namespace ImFlow
          */
         virtual std::weak_ptr<Link> getLink() { return std::weak_ptr<Link>{}; }
 
+        /**
+         * @brief <BR>Get if connections from an output on the same node are allowed
+         * @return [TRUE] if the pin is an input accepting links from its own node
+         */
+        virtual bool isSameNodeConnectionAllowed() { return false; }
+
+        /**
+         * @brief <BR>Get pin's outgoing links
+         * @return Const reference to the links of an output pin, empty for input pins
+         */
+        virtual const std::vector<std::weak_ptr<Link>>& getLinks() { static const std::vector<std::weak_ptr<Link>> none; return none; }
+
         /**
          * @brief <BR>Get pin's UID
          * @return Unique identifier of the pin
@@ -1049,9 +1944,22 @@ namespace ImFlow
 
         /**
          * @brief <BR>Get pin's style
-         * @return Smart pointer to pin's style
+         * @return Smart pointer to pin's style, possibly shared with other pins
+         */
+        const std::shared_ptr<const PinStyle>& getStyle() { return m_style; }
+
+        /**
+         * @brief <BR>Set pin's style
+         * @param style New style
+         */
+        void setStyle(std::shared_ptr<const PinStyle> style) { m_style = std::move(style); m_ownStyle = false; }
+
+        /**
+         * @brief <BR>Get pin's style for modification
+         * @details The style is copied on the first call after setStyle(), so the pins sharing it aren't affected.
+         * @return Reference to the pin's own style
          */
-        std::shared_ptr<PinStyle>& getStyle() { return m_style; }
+        PinStyle& editStyle();
 
         /**
          * @brief <BR>Get pin's link attachment point (socket)
@@ -1070,6 +1978,14 @@ namespace ImFlow
          * @param pos Position in screen coordinates
          */
         void setPos(ImVec2 pos) { m_pos = pos; }
+
+        /**
+         * @brief <BR>Move the pin along with its node, without laying it out
+         * @param from Previous position of the node in screen coordinates
+         * @param to New position of the node in screen coordinates
+         * @param ratio Change of the draw scale in between
+         */
+        void follow(const ImVec2& from, const ImVec2& to, float ratio) { m_pos = to + (m_pos - from) * ratio; m_size = m_size * ratio; }
     protected:
         PinUID m_uid;
         std::string m_name;
@@ -1078,7 +1994,8 @@ namespace ImFlow
         PinType m_type;
         BaseNode* m_parent = nullptr;
         ImNodeFlow** m_inf;
-        std::shared_ptr<PinStyle> m_style;
+        std::shared_ptr<const PinStyle> m_style;
+        bool m_ownStyle = false;
         std::function<void(Pin* p)> m_renderer;
     };
 
@@ -1110,8 +2027,8 @@ namespace ImFlow
          * @param inf Pointer to the Grid Handler the pin is in (same as parent)
          * @param style Style of the pin
          */
-        explicit InPin(PinUID uid, const std::string& name, T defReturn, std::function<bool(Pin*, Pin*)> filter, std::shared_ptr<PinStyle> style, BaseNode* parent, ImNodeFlow** inf)
-            : Pin(uid, name, style, PinType_Input, parent, inf), m_emptyVal(defReturn), m_filter(std::move(filter)) {}
+        explicit InPin(PinUID uid, const std::string& name, T defReturn, std::function<bool(Pin*, Pin*)> filter, std::shared_ptr<const PinStyle> style, BaseNode* parent, ImNodeFlow** inf)
+            : Pin(uid, name, style, PinType_Input, parent, inf), m_emptyVal(std::move(defReturn)), m_filter(std::move(filter)) {}
 
         /**
          * @brief <BR>Create link between pins
@@ -1122,7 +2039,7 @@ namespace ImFlow
         /**
         * @brief <BR>Delete the link connected to the pin
         */
-        void deleteLink() override { m_link.reset(); }
+        void deleteLink() override;
 
         /**
          * @brief Specify if connections from an output on the same node are allowed
@@ -1130,6 +2047,12 @@ namespace ImFlow
          */
         void allowSameNodeConnections(bool state) { m_allowSelfConnection = state; }
 
+        /**
+         * @brief <BR>Get if connections from an output on the same node are allowed
+         * @return [TRUE] if links from the same node are accepted
+         */
+        bool isSameNodeConnectionAllowed() override { return m_allowSelfConnection; }
+
         /**
          * @brief <BR>Get connected status
          * @return [TRUE] is pin is connected to a link
@@ -1142,6 +2065,12 @@ namespace ImFlow
          */
         std::weak_ptr<Link> getLink() override { return m_link; }
 
+        /**
+         * @brief <BR>Get the version of the connected output's value
+         * @return Version of the connected output, 0 if not connected
+         */
+        uint64_t getVersion() override { return m_link ? m_link->left()->getVersion() : 0; }
+
         /**
          * @brief <BR>Get InPin's connection filter
          * @return InPin's connection filter configuration
@@ -1158,7 +2087,7 @@ namespace ImFlow
          * @brief <BR>Get pin's link attachment point (socket)
          * @return Grid coordinates to the attachment point between the link and the pin's socket
          */
-        ImVec2 pinPoint() override { return m_pos + ImVec2(-m_style->extra.socket_padding, m_size.y / 2); }
+        ImVec2 pinPoint() override { return m_pos + ImVec2(-m_style->extra.socket_padding * (*m_inf)->getDrawScale(), m_size.y / 2); }
 
         /**
          * @brief <BR>Get value carried by the connected link
@@ -1188,7 +2117,7 @@ namespace ImFlow
          * @param inf Pointer to the Grid Handler the pin is in (same as parent)
          * @param style Style of the pin
          */
-        explicit OutPin(PinUID uid, const std::string& name, std::shared_ptr<PinStyle> style, BaseNode* parent, ImNodeFlow** inf)
+        explicit OutPin(PinUID uid, const std::string& name, std::shared_ptr<const PinStyle> style, BaseNode* parent, ImNodeFlow** inf)
             :Pin(uid, name, style, PinType_Output, parent, inf) {}
 
         /**
@@ -1197,6 +2126,9 @@ namespace ImFlow
         ~OutPin() override {
             std::vector<std::weak_ptr<Link>> links = std::move(m_links);
             for (auto &l: links) if (!l.expired()) l.lock()->right()->deleteLink();
+            // The job owns no reference to the pin, and the node may outlive its handler
+            if (m_future.valid() && *m_inf)
+                (*m_inf)->addPendingJobs(-1);
         }
 
         /**
@@ -1222,11 +2154,17 @@ namespace ImFlow
          */
         bool isConnected() override { return !m_links.empty(); }
 
+        /**
+         * @brief <BR>Get pin's outgoing links
+         * @return Const reference to the links connected to the pin
+         */
+        const std::vector<std::weak_ptr<Link>>& getLinks() override { return m_links; }
+
         /**
          * @brief <BR>Get pin's link attachment point (socket)
          * @return Grid coordinates to the attachment point between the link and the pin's socket
          */
-        ImVec2 pinPoint() override { return m_pos + ImVec2(m_size.x + m_style->extra.socket_padding, m_size.y / 2); }
+        ImVec2 pinPoint() override { return m_pos + ImVec2(m_size.x + m_style->extra.socket_padding * (*m_inf)->getDrawScale(), m_size.y / 2); }
 
         /**
          * @brief <BR>Get output value
@@ -1234,12 +2172,72 @@ namespace ImFlow
          */
         const T& val();
 
+        /**
+         * @brief <BR>Calculate the output value for the current evaluation
+         */
+        void resolve() override { val(); }
+
+        /**
+         * @brief <BR>Mark the value as outdated
+         * @details Propagates to all the nodes connected downstream
+         * @param walk Identifier of the propagation
+         */
+        void propagateDirty(uint64_t walk) override;
+
+        /**
+         * @brief <BR>Collect the value calculated in the background, if ready
+         */
+        void poll() override;
+
+        /**
+         * @brief <BR>Get pin's value state
+         * @return Whether the value is ready or still being calculated in the background
+         */
+        PinState getState() override;
+
+        /**
+         * @brief <BR>Get the exception thrown by the last asynchronous calculation
+         * @return Exception of the failed job, null if it succeeded
+         */
+        [[nodiscard]] std::exception_ptr getError() const { return m_error; }
+
+        /**
+         * @brief <BR>Get the version of the pin's value
+         * @return Number of times the value changed
+         */
+        uint64_t getVersion() override { return m_version; }
+
+        /**
+         * @brief <BR>Get dirty status
+         * @return [TRUE] if the value must be re-evaluated
+         */
+        [[nodiscard]] bool isDirty() const { return m_dirty; }
+
         /**
          * @brief <BR>Set logic to calculate output value
          * @details Used to define the pin behaviour. This is what gets the data from the parent's inputs, and applies the needed logic.
          * @param func Function or lambda expression used to calculate output value
          */
-        OutPin<T>* behaviour(std::function<T()> func) { m_behaviour = std::move(func); return this; }
+        OutPin<T>* behaviour(std::function<T()> func) { m_behaviour = std::move(func); m_inPlaceBehaviour = nullptr; m_asyncBehaviour = nullptr; return this; }
+
+        /**
+         * @brief <BR>Set logic to calculate output value in place
+         * @details The function receives the pin's value from the previous evaluation and updates it, so buffers can be reused instead of reallocated.
+         * @param func Function or lambda expression used to update the output value
+         */
+        OutPin<T>* behaviourInPlace(std::function<void(T&)> func) { m_inPlaceBehaviour = std::move(func); m_behaviour = nullptr; m_asyncBehaviour = nullptr; return this; }
+
+        /**
+         * @brief <BR>Set asynchronous logic to calculate output value
+         * @details The function runs when the value is needed, it must read the parent's inputs and return a job capturing everything by value.
+         *          The job runs on one of the handler's background threads, meanwhile the pin keeps returning the last value it produced.
+         *          Pulling the pin never blocks, a new job is only started once the previous one is collected.
+         *          Without incremental evaluation, a new job is only started when the version of an input changed or the node was marked dirty.
+         *          Inputs of types that can't be compared (see IsComparable), or computed in place, get a new version on every evaluation.
+         *          If the job throws, the pin keeps its previous value and reports PinState_Error.
+         * @param func Function or lambda expression returning the job that calculates the output value
+         */
+        OutPin<T>* behaviourAsync(std::function<std::function<T()>()> func) { m_asyncBehaviour = std::move(func); m_behaviour = nullptr; m_inPlaceBehaviour = nullptr; return this; }
 
         /**
          * @brief <BR>Get pin's data type (aka: \<T>)
@@ -1247,9 +2245,39 @@ namespace ImFlow
          */
         [[nodiscard]] const std::type_info& getDataType() const override { return typeid(T); };
     private:
+        /**
+         * @brief <BR>Run the behaviour that is set
+         * @details The version is only bumped when the value changed, as far as sameValue() can tell.
+         *          In-place behaviours always bump it, the previous value isn't kept to compare with.
+         */
+        void runBehaviour();
+
+        /**
+         * @brief <BR>Compare two values: bytewise if trivially copyable, with operator== if available
+         * @return [TRUE] if the values are known to be equal, [FALSE] for types that can't be compared
+         */
+        static bool sameValue(const T& a, const T& b);
+
+        /**
+         * @brief <BR>Combine the versions of the parent's inputs, evaluating them
+         */
+        uint64_t inputsVersion();
+
         std::vector<std::weak_ptr<Link>> m_links;
         std::function<T()> m_behaviour;
-        T m_val;
+        std::function<void(T&)> m_inPlaceBehaviour;
+        std::function<std::function<T()>()> m_asyncBehaviour;
+        std::future<T> m_future;
+        std::exception_ptr m_error;
+        bool m_hasVal = false;
+        uint64_t m_version = 0;
+        uint64_t m_inputsVersion = 0;
+        T m_val{};
+        uint64_t m_epoch = 0;
+        uint64_t m_dirtyWalk = 0;
+        uint64_t m_dirtySince = 0;
+        bool m_dirty = true;
+        bool m_evaluating = false;
     };
 }
 
@@ -7,31 +7,86 @@ namespace ImFlow {
     void Link::update() {
         ImVec2 start = m_left->pinPoint();
         ImVec2 end = m_right->pinPoint();
-        float thickness = m_left->getStyle()->extra.link_thickness;
+        float s = m_inf->getDrawScale();
+        float thickness = m_left->getStyle()->extra.link_thickness * s;
         bool mouseClickState = m_inf->getSingleUseClick();
 
         if (!ImGui::IsKeyDown(ImGuiKey_LeftCtrl) && ImGui::IsMouseClicked(ImGuiMouseButton_Left))
             m_selected = false;
 
-        if (smart_bezier_collider(ImGui::GetMousePos(), start, end, 2.5)) {
+        updateGeometry(end - start);
+        ImCubicBezierPoints curve = {m_cacheCurve.P0 + start, m_cacheCurve.P1 + start, m_cacheCurve.P2 + start,
+                                     m_cacheCurve.P3 + start};
+        ImRect bounds(m_cacheBounds.Min + start, m_cacheBounds.Max + start);
+
+        // Broad-phase on the bounding rect: projecting the mouse and drawing are only done for nearby and visible links
+        const float hoverRadius = 2.5f * s;
+        ImRect hoverBounds = bounds;
+        hoverBounds.Expand(hoverRadius);
+        m_inf->indexLink(this, ImRect(m_inf->screen2grid(hoverBounds.Min), m_inf->screen2grid(hoverBounds.Max)));
+
+        if (hoverBounds.Contains(ImGui::GetMousePos()) &&
+            ImProjectOnCubicBezier(ImGui::GetMousePos(), curve).Distance < hoverRadius) {
             m_hovered = true;
-            thickness = m_left->getStyle()->extra.link_hovered_thickness;
+            thickness = m_left->getStyle()->extra.link_hovered_thickness * s;
             if (mouseClickState) {
                 m_inf->consumeSingleUseClick();
                 m_selected = true;
             }
         } else { m_hovered = false; }
 
-        if (m_selected)
-            smart_bezier(start, end, m_left->getStyle()->extra.outline_color,
-                         thickness + m_left->getStyle()->extra.link_selected_outline_thickness);
-        smart_bezier(start, end, m_left->getStyle()->color, thickness);
+        ImDrawList *draw_list = ImGui::GetWindowDrawList();
+        float outline = thickness + m_left->getStyle()->extra.link_selected_outline_thickness * s;
+        bounds.Expand(outline);
+        if (bounds.Overlaps(ImRect(draw_list->GetClipRectMin(), draw_list->GetClipRectMax()))) {
+            if (m_selected)
+                strokeGeometry(start, m_left->getStyle()->extra.outline_color, outline);
+            strokeGeometry(start, m_left->getStyle()->color, thickness);
+        }
 
         if (m_selected && ImGui::IsKeyPressed(ImGuiKey_Delete, false))
             m_right->deleteLink();
     }
 
+    void Link::updateGeometry(const ImVec2 &delta) {
+        float scale = m_inf->getGrid().scale();
+        bool straight = m_inf->getStyle().lod_straight_links > 0.f && scale < m_inf->getStyle().lod_straight_links;
+        if (m_cacheScale == scale && m_cacheStraight == straight && m_cacheDelta.x == delta.x && m_cacheDelta.y == delta.y)
+            return;
+        m_cacheScale = scale;
+        m_cacheStraight = straight;
+        m_cacheDelta = delta;
+
+        if (straight) {
+            // Control points on the segment, hit-testing and bounds keep working on the "curve"
+            m_cacheCurve = {ImVec2(0.f, 0.f), delta / 3.f, delta * (2.f / 3.f), delta};
+            m_cacheBounds = ImCubicBezierBoundingRect(m_cacheCurve);
+            m_cachePolyline = {ImVec2(0.f, 0.f), delta};
+            return;
+        }
+        m_cacheCurve = smart_bezier_points(ImVec2(0.f, 0.f), delta);
+        m_cacheBounds = ImCubicBezierBoundingRect(m_cacheCurve);
+
+        // Tessellated by the draw list, same as AddBezierCubic()
+        ImDrawList *draw_list = ImGui::GetWindowDrawList();
+        draw_list->PathLineTo(m_cacheCurve.P0);
+        draw_list->PathBezierCubicCurveTo(m_cacheCurve.P1, m_cacheCurve.P2, m_cacheCurve.P3);
+        m_cachePolyline.assign(draw_list->_Path.Data, draw_list->_Path.Data + draw_list->_Path.Size);
+        draw_list->PathClear();
+    }
+
+    void Link::strokeGeometry(const ImVec2 &start, ImU32 color, float thickness) {
+        ImDrawList *draw_list = ImGui::GetWindowDrawList();
+        draw_list->_Path.resize((int)m_cachePolyline.size());
+        for (size_t i = 0; i < m_cachePolyline.size(); i++)
+            draw_list->_Path.Data[i] = m_cachePolyline[i] + start;
+        draw_list->PathStroke(color, 0, thickness);
+    }
+
     Link::~Link() {
+        // The link may outlive its handler
+        if (m_inf)
+            m_inf->unindexLink(this);
         if (!m_left) return;
         m_left->deleteLink();
     }
@@ -39,6 +94,97 @@ namespace ImFlow {
     // -----------------------------------------------------------------------------------------------------------------
     // BASE NODE
 
+    BaseNode::~BaseNode() {
+        // Outputs are released first and outside the lists, so links torn down by them can't reach back into them
+        std::vector<std::shared_ptr<Pin>> outs = std::move(m_outs);
+        std::vector<std::pair<uint32_t, std::shared_ptr<Pin>>> dynamicOuts = std::move(m_dynamicOuts);
+    }
+
+    void BaseNode::markDirty() {
+        propagateDirty(Pin::newDirtyWalk());
+    }
+
+    void BaseNode::propagateDirty(uint64_t walk) {
+        if (m_inf)
+            m_inf->requestRedraw();
+        for (auto &p: m_outs)
+            p->propagateDirty(walk);
+        for (auto &p: m_dynamicOuts)
+            p.second->propagateDirty(walk);
+    }
+
+    NodeStyle &BaseNode::editStyle() {
+        if (!m_ownStyle) {
+            // Called from the constructor, before the handler gave the node its default style
+            m_style = std::make_shared<NodeStyle>(m_style ? *m_style : *NodeStyle::cyan());
+            m_ownStyle = true;
+        }
+        // Only this node holds the copy
+        return const_cast<NodeStyle &>(*m_style);
+    }
+
+    PinStyle &Pin::editStyle() {
+        if (!m_ownStyle) {
+            m_style = std::make_shared<PinStyle>(*m_style);
+            m_ownStyle = true;
+        }
+        return const_cast<PinStyle &>(*m_style);
+    }
+
+    std::shared_ptr<MemoryResource> BaseNode::memoryResource() const {
+        return m_inf ? m_inf->getMemoryResource() : MemoryResource::current();
+    }
+
+    NodeProfileSample &BaseNode::profileSample() {
+        uint64_t frame = m_inf->getProfilerFrame();
+        // One more slot than the frames kept, for the frame being recorded
+        if (m_profile.size() != m_inf->getProfilerFrames() + 1)
+            m_profile.assign(m_inf->getProfilerFrames() + 1, NodeProfileSample());
+        NodeProfileSample &sample = m_profile[frame % m_profile.size()];
+        if (sample.frame != frame) {
+            sample = NodeProfileSample();
+            sample.frame = frame;
+        }
+        return sample;
+    }
+
+    void BaseNode::recordEvaluation(double inclusive, double self) {
+        NodeProfileSample &sample = profileSample();
+        sample.evalInclusive += inclusive;
+        sample.evalSelf += self;
+        sample.calls++;
+    }
+
+    NodeProfileSample BaseNode::getProfile(unsigned age) const {
+        uint64_t frame = m_inf->getProfilerFrame();
+        if (m_profile.empty() || age >= m_profile.size() || age >= frame)
+            return {};
+        const NodeProfileSample &sample = m_profile[(frame - age) % m_profile.size()];
+        return sample.frame == frame - age ? sample : NodeProfileSample();
+    }
+
+    NodeProfileSample BaseNode::getProfileAverage() const {
+        NodeProfileSample avg;
+        unsigned count = 0;
+        for (unsigned age = 1; age < m_profile.size(); age++) {
+            NodeProfileSample sample = getProfile(age);
+            if (sample.frame == 0)
+                continue;
+            avg.evalInclusive += sample.evalInclusive;
+            avg.evalSelf += sample.evalSelf;
+            avg.draw += sample.draw;
+            avg.calls += sample.calls;
+            count++;
+        }
+        if (count) {
+            avg.evalInclusive /= count;
+            avg.evalSelf /= count;
+            avg.draw /= count;
+            avg.calls /= count;
+        }
+        return avg;
+    }
+
     bool BaseNode::isHovered() {
         ImVec2 paddingTL = {m_style->padding.x, m_style->padding.y};
         ImVec2 paddingBR = {m_style->padding.z, m_style->padding.w};
@@ -47,15 +193,24 @@ namespace ImFlow {
     }
 
     void BaseNode::update() {
+        // Evaluations triggered while drawing are subtracted from the drawing time
+        std::optional<ProfilerScope> profile;
+        if (m_inf->isProfiling())
+            profile.emplace(this, true);
+
         ImDrawList *draw_list = ImGui::GetWindowDrawList();
         ImGui::PushID(this);
         bool mouseClickState = m_inf->getSingleUseClick();
-        ImVec2 offset = m_inf->grid2screen({0.f, 0.f});
+        // Layout is in screen space, sizes in grid units are scaled when drawing directly at zoom
+        float s = m_inf->getDrawScale();
+        ImVec2 origin = m_inf->grid2screen(m_pos);
         ImVec2 paddingTL = {m_style->padding.x, m_style->padding.y};
         ImVec2 paddingBR = {m_style->padding.z, m_style->padding.w};
 
         draw_list->ChannelsSetCurrent(1); // Foreground
-        ImGui::SetCursorScreenPos(offset + m_pos);
+        ImGui::SetCursorScreenPos(origin);
+        m_drawOrigin = origin;
+        m_drawScale = s;
 
         ImGui::BeginGroup();
 
@@ -67,20 +222,17 @@ namespace ImFlow {
         float headerH = ImGui::GetItemRectSize().y;
         float titleW = ImGui::GetItemRectSize().x;
 
-        // Inputs
+        // Inputs, dynamic ones are shown by draw() and laid out afterwards in the space they took last frame
+        ImVec2 dynamicInsPos = ImGui::GetCursorScreenPos();
         if (!m_ins.empty() || !m_dynamicIns.empty()) {
             ImGui::BeginGroup();
             for (auto &p: m_ins) {
-                p->setPos(ImGui::GetCursorPos());
+                p->setPos(ImGui::GetCursorScreenPos());
                 p->update();
             }
-            for (auto &p: m_dynamicIns) {
-                if (p.first == 1) {
-                    p.second->setPos(ImGui::GetCursorPos());
-                    p.second->update();
-                    p.first = 0;
-                }
-            }
+            dynamicInsPos = ImGui::GetCursorScreenPos();
+            if (m_dynamicInsSize.y > 0.f)
+                ImGui::Dummy(m_dynamicInsSize * s);
             ImGui::EndGroup();
             ImGui::SameLine();
         }
@@ -100,6 +252,8 @@ namespace ImFlow {
                 maxW = w;
         }
         for (auto &p: m_dynamicOuts) {
+            if (p.first != m_dynamicGeneration)
+                continue;
             float w = p.second->calcWidth();
             if (w > maxW)
                 maxW = w;
@@ -107,49 +261,117 @@ namespace ImFlow {
         ImGui::BeginGroup();
         for (auto &p: m_outs) {
             // FIXME: This looks horrible
-            if ((m_pos + ImVec2(titleW, 0) + m_inf->getGrid().scroll()).x <
-                ImGui::GetCursorPos().x + ImGui::GetWindowPos().x + maxW)
-                p->setPos(ImGui::GetCursorPos() + ImGui::GetWindowPos() + ImVec2(maxW - p->calcWidth(), 0.f));
+            if (origin.x + titleW < ImGui::GetCursorScreenPos().x + maxW)
+                p->setPos(ImGui::GetCursorScreenPos() + ImVec2(maxW - p->calcWidth(), 0.f));
             else
-                p->setPos(ImVec2((m_pos + ImVec2(titleW - p->calcWidth(), 0) + m_inf->getGrid().scroll()).x,
-                                 ImGui::GetCursorPos().y + ImGui::GetWindowPos().y));
+                p->setPos(ImVec2(origin.x + titleW - p->calcWidth(), ImGui::GetCursorScreenPos().y));
             p->update();
         }
         for (auto &p: m_dynamicOuts) {
+            if (p.first != m_dynamicGeneration)
+                continue;
             // FIXME: This looks horrible
-            if ((m_pos + ImVec2(titleW, 0) + m_inf->getGrid().scroll()).x <
-                ImGui::GetCursorPos().x + ImGui::GetWindowPos().x + maxW)
-                p.second->setPos(
-                        ImGui::GetCursorPos() + ImGui::GetWindowPos() + ImVec2(maxW - p.second->calcWidth(), 0.f));
+            if (origin.x + titleW < ImGui::GetCursorScreenPos().x + maxW)
+                p.second->setPos(ImGui::GetCursorScreenPos() + ImVec2(maxW - p.second->calcWidth(), 0.f));
             else
-                p.second->setPos(
-                        ImVec2((m_pos + ImVec2(titleW - p.second->calcWidth(), 0) + m_inf->getGrid().scroll()).x,
-                               ImGui::GetCursorPos().y + ImGui::GetWindowPos().y));
+                p.second->setPos(ImVec2(origin.x + titleW - p.second->calcWidth(), ImGui::GetCursorScreenPos().y));
             p.second->update();
-            p.first -= 1;
         }
 
         ImGui::EndGroup();
 
+        // Dynamic inputs, pins not shown this frame are left out before being pruned
+        m_dynamicInsSize = ImVec2(0.f, 0.f);
+        bool anyShown = std::any_of(m_dynamicIns.begin(), m_dynamicIns.end(),
+                                    [this](const std::pair<uint32_t, std::shared_ptr<Pin>> &p) { return p.first == m_dynamicGeneration; });
+        if (anyShown) {
+            ImGui::SetCursorScreenPos(dynamicInsPos);
+            ImGui::BeginGroup();
+            for (auto &p: m_dynamicIns) {
+                if (p.first != m_dynamicGeneration)
+                    continue;
+                p.second->setPos(ImGui::GetCursorScreenPos());
+                p.second->update();
+            }
+            ImGui::EndGroup();
+            m_dynamicInsSize = ImGui::GetItemRectSize() / s;
+        }
+
         ImGui::EndGroup();
-        m_size = ImGui::GetItemRectSize();
-        ImVec2 headerSize = ImVec2(m_size.x + paddingBR.x, headerH);
+        m_size = ImGui::GetItemRectSize() / s;
+        ImVec2 headerSize = ImVec2(m_size.x + paddingBR.x, headerH / s);
 
         // Background
         draw_list->ChannelsSetCurrent(0);
-        draw_list->AddRectFilled(offset + m_pos - paddingTL, offset + m_pos + m_size + paddingBR, m_style->bg,
-                                 m_style->radius);
-        draw_list->AddRectFilled(offset + m_pos - paddingTL, offset + m_pos + headerSize, m_style->header_bg,
-                                 m_style->radius, ImDrawFlags_RoundCornersTop);
+        drawBackground(origin, headerH / s);
         m_fullSize = m_size + paddingTL + paddingBR;
+
+        updateInteractions(mouseClickState, ImRect(origin - paddingTL * s, origin + headerSize * s));
+        ImGui::PopID();
+
+        pruneDynamicPins();
+    }
+
+    void BaseNode::pruneDynamicPins() {
+        // Nothing to remove if every pin was shown
+        if (m_dynamicShown != m_dynamicIns.size() + m_dynamicOuts.size()) {
+            // Destroyed once the lists are consistent again, as removing a pin can tear down links
+            std::vector<std::shared_ptr<Pin>> removed;
+            auto prune = [&](std::vector<std::pair<uint32_t, std::shared_ptr<Pin>>> &pins,
+                             std::unordered_map<PinUID, uint32_t> &index) {
+                size_t kept = 0;
+                for (size_t i = 0; i < pins.size(); i++) {
+                    if (pins[i].first != m_dynamicGeneration) {
+                        index.erase(pins[i].second->getUid());
+                        removed.push_back(std::move(pins[i].second));
+                        continue;
+                    }
+                    if (kept != i) {
+                        pins[kept] = std::move(pins[i]);
+                        index[pins[kept].second->getUid()] = (uint32_t)kept;
+                    }
+                    kept++;
+                }
+                pins.resize(kept);
+            };
+            prune(m_dynamicIns, m_dynamicInsIndex);
+            prune(m_dynamicOuts, m_dynamicOutsIndex);
+            if (!removed.empty() && m_inf)
+                m_inf->invalidateEvaluationPlan();
+        }
+        m_dynamicGeneration++;
+        m_dynamicShown = 0;
+    }
+
+    void BaseNode::drawBackground(const ImVec2 &origin, float headerH) {
+        ImDrawList *draw_list = ImGui::GetWindowDrawList();
+        float s = m_inf->getDrawScale();
         ImU32 col = m_style->border_color;
         float thickness = m_style->border_thickness;
-        ImVec2 ptl = paddingTL;
-        ImVec2 pbr = paddingBR;
         if (m_selected) {
             col = m_style->border_selected_color;
             thickness = m_style->border_selected_thickness;
         }
+
+        DrawCacheKey key{m_size, headerH, s, headerColor(), m_style->bg, col, m_style->radius, thickness,
+                         m_style->padding, draw_list->_Data->TexUvWhitePixel};
+        bool cache = m_inf->isNodeDrawCache();
+        if (cache && m_drawCache.valid() && memcmp(&key, &m_drawCacheKey, sizeof(DrawCacheKey)) == 0) {
+            m_drawCache.replay(draw_list, origin);
+            return;
+        }
+        if (cache)
+            m_drawCache.begin(draw_list);
+
+        ImVec2 paddingTL = {m_style->padding.x, m_style->padding.y};
+        ImVec2 paddingBR = {m_style->padding.z, m_style->padding.w};
+        ImVec2 headerSize = ImVec2(m_size.x + paddingBR.x, headerH);
+        draw_list->AddRectFilled(origin - paddingTL * s, origin + (m_size + paddingBR) * s, m_style->bg,
+                                 m_style->radius * s);
+        draw_list->AddRectFilled(origin - paddingTL * s, origin + headerSize * s, key.header,
+                                 m_style->radius * s, ImDrawFlags_RoundCornersTop);
+        ImVec2 ptl = paddingTL;
+        ImVec2 pbr = paddingBR;
         if (thickness < 0.f) {
             ptl.x -= thickness / 2;
             ptl.y -= thickness / 2;
@@ -157,9 +379,25 @@ namespace ImFlow {
             pbr.y -= thickness / 2;
             thickness *= -1.f;
         }
-        draw_list->AddRect(offset + m_pos - ptl, offset + m_pos + m_size + pbr, col, m_style->radius, 0, thickness);
+        draw_list->AddRect(origin - ptl * s, origin + (m_size + pbr) * s, col, m_style->radius * s, 0, thickness * s);
 
+        if (cache && m_drawCache.end(draw_list, origin))
+            m_drawCacheKey = key;
+    }
+
+    ImU32 BaseNode::headerColor() {
+        if (!m_inf->isProfilerOverlay() || m_inf->getProfilerMaxCost() <= 0.0)
+            return m_style->header_bg;
 
+        // Tinted by the cost of the last frame, relative to the most expensive node
+        NodeProfileSample last = getProfile(1);
+        float t = (float)((last.evalSelf + last.draw) / m_inf->getProfilerMaxCost());
+        ImVec4 cold = ImGui::ColorConvertU32ToFloat4(m_style->header_bg);
+        ImVec4 hot = ImGui::ColorConvertU32ToFloat4(m_inf->getStyle().colors.profilerHot);
+        return ImGui::ColorConvertFloat4ToU32(ImLerp(cold, hot, ImSaturate(t)));
+    }
+
+    void BaseNode::updateInteractions(bool mouseClickState, const ImRect &handle) {
         if (ImGui::IsWindowHovered() && !ImGui::IsKeyDown(ImGuiKey_LeftCtrl) &&
             ImGui::IsMouseClicked(ImGuiMouseButton_Left) && !m_inf->on_selected_node())
             selected(false);
@@ -169,13 +407,14 @@ namespace ImFlow {
             if (mouseClickState) {
                 selected(true);
                 m_inf->consumeSingleUseClick();
+                m_inf->bringToFront(m_uid);
             }
         }
 
         if (ImGui::IsWindowFocused() && ImGui::IsKeyPressed(ImGuiKey_Delete) && !ImGui::IsAnyItemActive() && isSelected())
             destroy();
 
-        bool onHeader = ImGui::IsMouseHoveringRect(offset + m_pos - paddingTL, offset + m_pos + headerSize);
+        bool onHeader = ImGui::IsMouseHoveringRect(handle.Min, handle.Max);
         if (onHeader && mouseClickState) {
             m_inf->consumeSingleUseClick();
             m_dragged = true;
@@ -194,15 +433,69 @@ namespace ImFlow {
                 m_posTarget = m_pos;
             }
         }
+        ImVec2 paddingTL = {m_style->padding.x, m_style->padding.y};
+        m_inf->indexNode(this, ImRect(m_pos - paddingTL, m_pos - paddingTL + m_fullSize));
+    }
+
+    void BaseNode::updateSimplified() {
+        std::optional<ProfilerScope> profile;
+        if (m_inf->isProfiling())
+            profile.emplace(this, true);
+
+        ImDrawList *draw_list = ImGui::GetWindowDrawList();
+        ImGui::PushID(this);
+        bool mouseClickState = m_inf->getSingleUseClick();
+        float s = m_inf->getDrawScale();
+        ImVec2 paddingTL = {m_style->padding.x, m_style->padding.y};
+
+        // Pins aren't laid out, they follow the node with the sizes of the last full update
+        updateCulled();
+
+        ImVec2 min = m_inf->grid2screen(m_pos - paddingTL);
+        ImVec2 max = min + m_fullSize * s;
+        draw_list->ChannelsSetCurrent(0);
+        draw_list->AddRectFilled(min, max, headerColor(), m_style->radius * s);
+        if (m_selected)
+            draw_list->AddRect(min, max, m_style->border_selected_color, m_style->radius * s, 0,
+                               m_style->border_selected_thickness * s);
+
+        draw_list->ChannelsSetCurrent(1);
+        for (auto &p: m_ins)
+            p->drawSocket();
+        for (auto &p: m_dynamicIns)
+            p.second->drawSocket();
+        for (auto &p: m_outs)
+            p->drawSocket();
+        for (auto &p: m_dynamicOuts)
+            p.second->drawSocket();
+
+        // The box acts as header, except for the side paddings where the sockets are
+        updateInteractions(mouseClickState, ImRect(min + ImVec2(m_style->padding.x * s, 0.f),
+                                                   max - ImVec2(m_style->padding.z * s, 0.f)));
         ImGui::PopID();
+    }
 
-        // Deleting dead pins
-        m_dynamicIns.erase(std::remove_if(m_dynamicIns.begin(), m_dynamicIns.end(),
-                                          [](const std::pair<int, std::shared_ptr<Pin>> &p) { return p.first == 0; }),
-                           m_dynamicIns.end());
-        m_dynamicOuts.erase(std::remove_if(m_dynamicOuts.begin(), m_dynamicOuts.end(),
-                                           [](const std::pair<int, std::shared_ptr<Pin>> &p) { return p.first == 0; }),
-                            m_dynamicOuts.end());
+    void BaseNode::updateCulled() {
+        // Pins are positioned in screen space, follow scrolling, zooming (direct mode) and node movements since the last update()
+        ImVec2 origin = m_inf->grid2screen(m_pos);
+        float s = m_inf->getDrawScale();
+        if (origin.x == m_drawOrigin.x && origin.y == m_drawOrigin.y && s == m_drawScale)
+            return;
+        ImVec2 from = m_drawOrigin;
+        float ratio = s / m_drawScale;
+        m_drawOrigin = origin;
+        m_drawScale = s;
+        // Only moved by setPos() while culled
+        ImVec2 paddingTL = {m_style->padding.x, m_style->padding.y};
+        m_inf->indexNode(this, ImRect(m_pos - paddingTL, m_pos - paddingTL + m_fullSize));
+        for (auto &p: m_ins)
+            p->follow(from, origin, ratio);
+        for (auto &p: m_dynamicIns)
+            p.second->follow(from, origin, ratio);
+        for (auto &p: m_outs)
+            p->follow(from, origin, ratio);
+        for (auto &p: m_dynamicOuts)
+            p.second->follow(from, origin, ratio);
     }
 
     // -----------------------------------------------------------------------------------------------------------------
@@ -210,16 +503,131 @@ namespace ImFlow {
 
     int ImNodeFlow::m_instances = 0;
 
+    ImNodeFlow::~ImNodeFlow() {
+        detachAll();
+    }
+
+    void ImNodeFlow::detachAll() {
+        for (auto &node: m_nodes)
+            node->setHandler(nullptr);
+        for (auto &l: m_links)
+            if (auto link = l.lock())
+                link->setHandler(nullptr);
+    }
+
     bool ImNodeFlow::on_selected_node() {
-        return std::any_of(m_nodes.begin(), m_nodes.end(),
-                           [](const auto &n) { return n.second->isSelected() && n.second->isHovered(); });
+        bool found = false;
+        m_nodeIndex.queryPoint(screen2grid(ImGui::GetMousePos()), [&](BaseNode *n) {
+            found |= n->isSelected() && n->isHovered();
+        });
+        return found;
     }
 
     bool ImNodeFlow::on_free_space() {
-        return std::all_of(m_nodes.begin(), m_nodes.end(),
-                           [](const auto &n) { return !n.second->isHovered(); })
-               && std::all_of(m_links.begin(), m_links.end(),
-                              [](const auto &l) { return !l.lock()->isHovered(); });
+        ImVec2 mouse = screen2grid(ImGui::GetMousePos());
+        bool free = true;
+        m_nodeIndex.queryPoint(mouse, [&](BaseNode *n) { free &= !n->isHovered(); });
+        m_linkIndex.queryPoint(mouse, [&](Link *l) { free &= !l->isHovered(); });
+        return free;
+    }
+
+    BaseNode *ImNodeFlow::getNode(NodeUID uid) {
+        std::shared_ptr<BaseNode> *node = m_nodes.get(uid);
+        return node ? node->get() : nullptr;
+    }
+
+    void ImNodeFlow::bringToFront(NodeUID uid) {
+        m_raised.push_back(uid);
+    }
+
+    bool ImNodeFlow::removeNode(NodeUID uid) {
+        std::shared_ptr<BaseNode> *found = m_nodes.get(uid);
+        if (!found)
+            return false;
+
+        // Forget the interactions involving the node or its pins
+        BaseNode *node = found->get();
+        auto owned = [node](Pin *p) { return p && p->getParent() == node; };
+        if (m_hoveredNode == node)
+            m_hoveredNode = nullptr;
+        if (m_hoveredNodeAux == node)
+            m_hoveredNodeAux = nullptr;
+        if (owned(m_hovering))
+            m_hovering = nullptr;
+        if (owned(m_droppedLinkLeft))
+            m_droppedLinkLeft = nullptr;
+        if (owned(m_dragOut)) {
+            m_dragOut = nullptr;
+            m_dragBlocked.clear();
+        }
+        m_dragBlocked.erase(node);
+
+        auto it = std::find(m_zOrder.begin(), m_zOrder.end(), uid);
+        if (it != m_zOrder.end())
+            m_zOrder.erase(it);
+        m_nodeIndex.remove(node);
+        m_nodes.erase(uid);
+        invalidateEvaluationPlan();
+        return true;
+    }
+
+    MemoryReport ImNodeFlow::memoryReport() {
+        MemoryReport r;
+        r.nodes = m_memory->counters(MemoryKind_Node).bytes;
+        r.pins = m_memory->counters(MemoryKind_Pin).bytes;
+        r.links = m_memory->counters(MemoryKind_Link).bytes;
+
+        std::unordered_set<const void *> styles;
+        auto count = [&](const void *style, size_t size) {
+            if (style && styles.insert(style).second)
+                r.styles += size;
+        };
+        for (auto &node: m_nodes) {
+            count(node->getStyle().get(), sizeof(NodeStyle));
+            for (auto &p: node->getIns())
+                count(p->getStyle().get(), sizeof(PinStyle));
+            for (auto &p: node->getOuts())
+                count(p->getStyle().get(), sizeof(PinStyle));
+            for (auto &p: node->getDynamicIns())
+                count(p.second->getStyle().get(), sizeof(PinStyle));
+            for (auto &p: node->getDynamicOuts())
+                count(p.second->getStyle().get(), sizeof(PinStyle));
+        }
+        r.styleCount = styles.size();
+        return r;
+    }
+
+    void ImNodeFlow::clear() {
+        m_hoveredNode = m_hoveredNodeAux = nullptr;
+        m_hovering = m_dragOut = m_droppedLinkLeft = nullptr;
+        m_dragBlocked.clear();
+        m_zOrder.clear();
+        m_raised.clear();
+        // Nodes referenced elsewhere survive, detached. Links are released along with the pins owning them
+        detachAll();
+        m_nodes.clear();
+        m_nodeIndex.clear();
+        m_links.clear();
+        m_linkIndex.clear();
+        m_topoNext = 0;
+        m_topoValid = true;
+        invalidateEvaluationPlan();
+        m_memory->release();
+    }
+
+    void ImNodeFlow::applyRaised() {
+        for (NodeUID uid: m_raised) {
+            auto it = std::find(m_zOrder.begin(), m_zOrder.end(), uid);
+            if (it != m_zOrder.end())
+                std::rotate(it, it + 1, m_zOrder.end());
+        }
+        m_raised.clear();
+    }
+
+    std::vector<BaseNode *> ImNodeFlow::getNodesInRect(const ImVec2 &min, const ImVec2 &max) {
+        std::vector<BaseNode *> nodes;
+        m_nodeIndex.queryRect(ImRect(min, max), [&](BaseNode *n) { nodes.push_back(n); });
+        return nodes;
     }
 
     ImVec2 ImNodeFlow::screen2grid( const ImVec2 & p )
@@ -240,46 +648,444 @@ namespace ImFlow {
         m_links.push_back(link);
     }
 
+    void ImNodeFlow::drawGrid(ImDrawList *draw_list, const ImVec2 &pos, const ImVec2 &size) {
+        float step = m_style.grid_size * getDrawScale();
+        float subStep = step / m_style.grid_subdivisions;
+
+        // Sub-grid fades out while zooming out
+        float fade = m_context.scale() >= m_style.subgrid_fade_max ? 1.f : 0.f;
+        if (m_style.subgrid_fade_max > m_style.subgrid_fade_min)
+            fade = ImSaturate((m_context.scale() - m_style.subgrid_fade_min) /
+                              (m_style.subgrid_fade_max - m_style.subgrid_fade_min));
+        ImU32 subGrid = m_style.colors.subGrid;
+        ImU32 alpha = (ImU32)((float)((subGrid >> IM_COL32_A_SHIFT) & 0xFF) * fade);
+        subGrid = (subGrid & ~IM_COL32_A_MASK) | (alpha << IM_COL32_A_SHIFT);
+
+        // The pattern repeats every step: it's drawn one step larger than the window and moved with the scroll
+        ImVec2 offset = grid2screen({0.f, 0.f}) - pos;
+        ImVec2 shift(fmodf(offset.x, step), fmodf(offset.y, step));
+        if (shift.x > 0.f)
+            shift.x -= step;
+        if (shift.y > 0.f)
+            shift.y -= step;
+        ImVec2 origin = pos + shift;
+
+        GridCacheKey key{size, step, subStep, m_style.colors.grid, subGrid, draw_list->_Data->TexUvWhitePixel};
+        if (m_gridDrawCache && m_gridCache.valid() && memcmp(&key, &m_gridCacheKey, sizeof(GridCacheKey)) == 0) {
+            m_gridCache.replay(draw_list, origin);
+            return;
+        }
+        if (m_gridDrawCache)
+            m_gridCache.begin(draw_list);
+
+        ImVec2 extent = size + ImVec2(step, step);
+        for (float x = 0.f; x < extent.x; x += step)
+            draw_list->AddLine(origin + ImVec2(x, 0.0f), origin + ImVec2(x, extent.y), m_style.colors.grid);
+        for (float y = 0.f; y < extent.y; y += step)
+            draw_list->AddLine(origin + ImVec2(0.0f, y), origin + ImVec2(extent.x, y), m_style.colors.grid);
+        if (alpha > 0) {
+            for (float x = 0.f; x < extent.x; x += subStep)
+                draw_list->AddLine(origin + ImVec2(x, 0.0f), origin + ImVec2(x, extent.y), subGrid);
+            for (float y = 0.f; y < extent.y; y += subStep)
+                draw_list->AddLine(origin + ImVec2(0.0f, y), origin + ImVec2(extent.x, y), subGrid);
+        }
+
+        if (m_gridDrawCache && m_gridCache.end(draw_list, origin))
+            m_gridCacheKey = key;
+    }
+
+    void ImNodeFlow::buildEvaluationPlan() {
+        // Kahn's algorithm on the nodes, a node is ready once all the nodes feeding its inputs are planned
+        std::vector<BaseNode*> nodes;
+        std::unordered_map<BaseNode*, uint32_t> index;
+        nodes.reserve(m_nodes.size());
+        index.reserve(m_nodes.size());
+        for (auto &node: m_nodes) {
+            index[node.get()] = (uint32_t)nodes.size();
+            nodes.push_back(node.get());
+        }
+
+        std::vector<uint32_t> dependencies(nodes.size(), 0);
+        std::vector<std::vector<uint32_t>> downstream(nodes.size());
+        auto addDependency = [&](uint32_t i, Pin* in) {
+            auto link = in->getLink().lock();
+            if (!link)
+                return;
+            auto it = index.find(link->left()->getParent());
+            if (it == index.end() || it->second == i)
+                return;
+            downstream[it->second].push_back(i);
+            dependencies[i]++;
+        };
+        for (uint32_t i = 0; i < nodes.size(); i++) {
+            for (auto &p: nodes[i]->getIns())
+                addDependency(i, p.get());
+            for (auto &p: nodes[i]->getDynamicIns())
+                addDependency(i, p.second.get());
+        }
+
+        std::vector<uint32_t> pending = dependencies;
+        std::vector<uint32_t> order;
+        order.reserve(nodes.size());
+        for (uint32_t i = 0; i < nodes.size(); i++)
+            if (pending[i] == 0)
+                order.push_back(i);
+        for (size_t head = 0; head < order.size(); head++)
+            for (uint32_t d: downstream[order[head]])
+                if (--pending[d] == 0)
+                    order.push_back(d);
+        // Nodes on (or fed by) a cycle are resolved last, the cycle is broken like in a recursive pull
+        m_evalAcyclic = order.size();
+        if (order.size() < nodes.size())
+            for (uint32_t i = 0; i < nodes.size(); i++)
+                if (pending[i] != 0)
+                    order.push_back(i);
+
+        // Store the graph in evaluation order
+        std::vector<uint32_t> rank(nodes.size());
+        for (uint32_t i = 0; i < order.size(); i++)
+            rank[order[i]] = i;
+        m_evalPlan.clear();
+        m_evalIndex.clear();
+        m_evalNodes.resize(order.size());
+        m_evalDependencies.resize(order.size());
+        m_evalDownstream.resize(order.size());
+        for (uint32_t i = 0; i < order.size(); i++) {
+            BaseNode *node = nodes[order[i]];
+            m_evalNodes[i] = node;
+            m_evalIndex[node] = i;
+            m_evalDependencies[i] = dependencies[order[i]];
+            m_evalDownstream[i].clear();
+            for (uint32_t d: downstream[order[i]])
+                m_evalDownstream[i].push_back(rank[d]);
+            for (auto &p: node->getOuts())
+                m_evalPlan.push_back(p.get());
+            for (auto &p: node->getDynamicOuts())
+                m_evalPlan.push_back(p.second.get());
+        }
+        m_evalPlanValid = true;
+    }
+
+    void ImNodeFlow::submitJob(std::function<void()> job) {
+        // Async behaviours of thread-safe nodes start jobs from the workers of evaluateParallel()
+        std::lock_guard<std::mutex> lock(m_jobsMutex);
+        unsigned threads = m_jobThreads ? m_jobThreads : std::max(1u, std::thread::hardware_concurrency());
+        // Only resized while idle, destroying the queue waits for its jobs
+        if (!m_jobs || (m_jobs->size() != threads && m_pendingJobs == 0))
+            m_jobs = std::make_unique<JobQueue>(threads);
+        m_jobs->push(std::move(job));
+    }
+
+    void ImNodeFlow::pollPendingJobs() {
+        if (m_pendingJobs == 0)
+            return;
+        for (auto &node: m_nodes) {
+            for (auto &p: node->getOuts())
+                p->poll();
+            for (auto &p: node->getDynamicOuts())
+                p.second->poll();
+        }
+    }
+
+    void ImNodeFlow::evaluate() {
+        pollPendingJobs();
+        if (!m_evalPlanValid)
+            buildEvaluationPlan();
+
+        m_evalEpoch++;
+        for (Pin *p: m_evalPlan)
+            p->resolve();
+    }
+
+    void ImNodeFlow::evaluate(const std::vector<Pin *> &sinks) {
+        pollPendingJobs();
+        if (!m_evalPlanValid)
+            buildEvaluationPlan();
+
+        // Flag every node the sinks depend on
+        m_evalNeeded.assign(m_evalNodes.size(), 0);
+        std::vector<BaseNode*> stack;
+        auto require = [&](BaseNode *node) {
+            auto it = m_evalIndex.find(node);
+            if (it == m_evalIndex.end() || m_evalNeeded[it->second])
+                return;
+            m_evalNeeded[it->second] = 1;
+            stack.push_back(node);
+        };
+        auto requireUpstream = [&](Pin *in) {
+            if (auto link = in->getLink().lock())
+                require(link->left()->getParent());
+        };
+        for (Pin *p: sinks) {
+            if (p->getType() == PinType_Input)
+                requireUpstream(p);
+            else
+                require(p->getParent());
+        }
+        while (!stack.empty()) {
+            BaseNode *node = stack.back();
+            stack.pop_back();
+            for (auto &p: node->getIns())
+                requireUpstream(p.get());
+            for (auto &p: node->getDynamicIns())
+                requireUpstream(p.second.get());
+        }
+
+        m_evalEpoch++;
+        for (size_t i = 0; i < m_evalNodes.size(); i++) {
+            if (!m_evalNeeded[i])
+                continue;
+            for (auto &p: m_evalNodes[i]->getOuts())
+                p->resolve();
+            for (auto &p: m_evalNodes[i]->getDynamicOuts())
+                p.second->resolve();
+        }
+    }
+
+    void ImNodeFlow::evaluateParallel() {
+        pollPendingJobs();
+        if (!m_evalPlanValid)
+            buildEvaluationPlan();
+        if (!m_evalPool)
+            m_evalPool = std::make_unique<WorkStealingPool>(m_evalThreads ? m_evalThreads : std::thread::hardware_concurrency());
+
+        m_evalEpoch++;
+        auto resolveNode = [](BaseNode *node) {
+            for (auto &p: node->getOuts())
+                p->resolve();
+            for (auto &p: node->getDynamicOuts())
+                p.second->resolve();
+        };
+        auto task = [this](uint32_t i) {
+            return m_evalNodes[i]->isThreadSafe() ? i : i | WorkStealingPool::PinnedTask;
+        };
+
+        // A node is pushed by the last of its upstream nodes to be resolved
+        std::unique_ptr<std::atomic<uint32_t>[]> pending(new std::atomic<uint32_t>[m_evalAcyclic]);
+        std::vector<WorkStealingPool::Task> seeds;
+        for (uint32_t i = 0; i < m_evalAcyclic; i++) {
+            pending[i].store(m_evalDependencies[i], std::memory_order_relaxed);
+            if (m_evalDependencies[i] == 0)
+                seeds.push_back(task(i));
+        }
+        m_evalPool->run(seeds, m_evalAcyclic, [&](WorkStealingPool::Task i, unsigned worker) {
+            resolveNode(m_evalNodes[i]);
+            for (uint32_t d: m_evalDownstream[i])
+                if (d < m_evalAcyclic && pending[d].fetch_sub(1, std::memory_order_acq_rel) == 1)
+                    m_evalPool->push(worker, task(d));
+        });
+
+        for (size_t i = m_evalAcyclic; i < m_evalNodes.size(); i++)
+            resolveNode(m_evalNodes[i]);
+    }
+
+    void ImNodeFlow::incrementalEvaluation(bool state) {
+        // Values cached while not incremental weren't tracked
+        if (state && !m_incremental)
+            for (auto &node: m_nodes)
+                node->markDirty();
+        m_incremental = state;
+    }
+
+    bool ImNodeFlow::collectReachable(BaseNode *start, bool downstream, uint32_t bound, BaseNode *target,
+                                      std::vector<BaseNode *> &found, const Link *skip) {
+        found.clear();
+        m_topoVisited.clear();
+        m_topoVisited.insert(start);
+        found.push_back(start);
+        auto visit = [&](BaseNode *node) {
+            if (downstream ? node->getTopologicalOrder() > bound : node->getTopologicalOrder() < bound)
+                return;
+            if (m_topoVisited.insert(node).second)
+                found.push_back(node);
+        };
+        auto visitOut = [&](Pin *out) {
+            for (auto &l: out->getLinks())
+                if (auto link = l.lock(); link && link.get() != skip)
+                    visit(link->right()->getParent());
+        };
+        auto visitIn = [&](Pin *in) {
+            if (auto link = in->getLink().lock(); link && link.get() != skip)
+                visit(link->left()->getParent());
+        };
+        // "found" doubles as the queue
+        for (size_t head = 0; head < found.size(); head++) {
+            BaseNode *node = found[head];
+            if (node == target)
+                return true;
+            if (downstream) {
+                for (auto &p: node->getOuts())
+                    visitOut(p.get());
+                for (auto &p: node->getDynamicOuts())
+                    visitOut(p.second.get());
+            } else {
+                for (auto &p: node->getIns())
+                    visitIn(p.get());
+                for (auto &p: node->getDynamicIns())
+                    visitIn(p.second.get());
+            }
+        }
+        return false;
+    }
+
+    void ImNodeFlow::rebuildTopologicalOrder() {
+        if (!m_evalPlanValid)
+            buildEvaluationPlan();
+        if (m_evalAcyclic < m_evalNodes.size())
+            return;
+        for (uint32_t i = 0; i < m_evalNodes.size(); i++)
+            m_evalNodes[i]->setTopologicalOrder(i);
+        m_topoNext = (uint32_t)m_evalNodes.size();
+        m_topoValid = true;
+    }
+
+    bool ImNodeFlow::wouldCreateCycle(Pin *out, Pin *in) {
+        if (out->getType() == PinType_Input)
+            std::swap(out, in);
+        BaseNode *from = out->getParent(), *to = in->getParent();
+        if (from == to)
+            return !in->isSameNodeConnectionAllowed();
+
+        // The link replaced by the new one doesn't count
+        std::shared_ptr<Link> replaced = in->getLink().lock();
+        if (!m_topoValid)
+            rebuildTopologicalOrder();
+        // The graph already contains cycles, no order to rely on
+        if (!m_topoValid)
+            return collectReachable(to, true, UINT32_MAX, from, m_topoForward, replaced.get());
+
+        // Nodes after "from" in the order can't reach it
+        if (from->getTopologicalOrder() < to->getTopologicalOrder())
+            return false;
+        return collectReachable(to, true, from->getTopologicalOrder(), from, m_topoForward, replaced.get());
+    }
+
+    void ImNodeFlow::linkTopologicalOrder(BaseNode *from, BaseNode *to) {
+        // Self-links are ignored by the evaluation order as well
+        if (!m_topoValid || from == to)
+            return;
+        uint32_t lower = to->getTopologicalOrder(), upper = from->getTopologicalOrder();
+        if (upper < lower)
+            return;
+
+        // Pearce-Kelly: only the nodes ordered between the two ends need to move
+        if (collectReachable(to, true, upper, from, m_topoForward)) {
+            m_topoValid = false; // The link closed a cycle
+            return;
+        }
+        collectReachable(from, false, lower, nullptr, m_topoBackward);
+
+        // The upstream of "from" takes the lowest of the freed slots, the downstream of "to" the highest
+        auto byOrder = [](BaseNode *a, BaseNode *b) { return a->getTopologicalOrder() < b->getTopologicalOrder(); };
+        std::sort(m_topoBackward.begin(), m_topoBackward.end(), byOrder);
+        std::sort(m_topoForward.begin(), m_topoForward.end(), byOrder);
+        std::vector<uint32_t> slots;
+        slots.reserve(m_topoBackward.size() + m_topoForward.size());
+        for (BaseNode *n: m_topoBackward)
+            slots.push_back(n->getTopologicalOrder());
+        for (BaseNode *n: m_topoForward)
+            slots.push_back(n->getTopologicalOrder());
+        std::sort(slots.begin(), slots.end());
+        size_t i = 0;
+        for (BaseNode *n: m_topoBackward)
+            n->setTopologicalOrder(slots[i++]);
+        for (BaseNode *n: m_topoForward)
+            n->setTopologicalOrder(slots[i++]);
+    }
+
+    bool ImNodeFlow::isLinkTargetBlocked(Pin *pin) {
+        if (!m_rejectCycles || !m_dragOut || pin->getType() == m_dragOut->getType())
+            return false;
+        if (pin->getParent() == m_dragOut->getParent()) {
+            Pin *in = pin->getType() == PinType_Input ? pin : m_dragOut;
+            return !in->isSameNodeConnectionAllowed();
+        }
+        return m_dragBlocked.count(pin->getParent()) != 0;
+    }
+
     void ImNodeFlow::update() {
         // Updating looping stuff
         m_hovering = nullptr;
         m_hoveredNode = nullptr;
         m_draggingNode = m_draggingNodeNext;
         m_singleUseClick = ImGui::IsMouseClicked(ImGuiMouseButton_Left);
+        // Running jobs (and the frame completing them) and the profiler overlay change without any input
+        if (m_pendingJobs > 0 || m_profilerOverlay)
+            requestRedraw();
+        pollPendingJobs();
 
-        // Create child canvas
-        m_context.begin();
-        ImGui::GetIO().IniFilename = nullptr;
+        // Create child canvas, an idle frame is replayed as is
+        if (!m_context.begin())
+        {
+            m_context.end();
+            return;
+        }
+        if (!isDirectZoom())
+            ImGui::GetIO().IniFilename = nullptr;
 
         ImDrawList *draw_list = ImGui::GetWindowDrawList();
+        float s = getDrawScale();
 
         // Display grid
+        ImVec2 gridPos = ImGui::GetWindowPos();
         ImVec2 gridSize = ImGui::GetWindowSize();
-        float subGridStep = m_style.grid_size / m_style.grid_subdivisions;
-        for (float x = fmodf(m_context.scroll().x, m_style.grid_size); x < gridSize.x; x += m_style.grid_size)
-            draw_list->AddLine(ImVec2(x, 0.0f), ImVec2(x, gridSize.y), m_style.colors.grid);
-        for (float y = fmodf(m_context.scroll().y, m_style.grid_size); y < gridSize.y; y += m_style.grid_size)
-            draw_list->AddLine(ImVec2(0.0f, y), ImVec2(gridSize.x, y), m_style.colors.grid);
-        if (m_context.scale() > 0.7f) {
-            for (float x = fmodf(m_context.scroll().x, subGridStep); x < gridSize.x; x += subGridStep)
-                draw_list->AddLine(ImVec2(x, 0.0f), ImVec2(x, gridSize.y), m_style.colors.subGrid);
-            for (float y = fmodf(m_context.scroll().y, subGridStep); y < gridSize.y; y += subGridStep)
-                draw_list->AddLine(ImVec2(0.0f, y), ImVec2(gridSize.x, y), m_style.colors.subGrid);
+        drawGrid(draw_list, gridPos, gridSize);
+
+        // Scale of the profiler overlay
+        if (m_profilerOverlay) {
+            m_profilerMaxCost = 0.0;
+            for (auto &node: m_nodes) {
+                NodeProfileSample last = node->getProfile(1);
+                m_profilerMaxCost = std::max(m_profilerMaxCost, last.evalSelf + last.draw);
+            }
         }
 
         // Update and draw nodes
         // TODO: I don't like this
         draw_list->ChannelsSplit(2);
-        for (auto &node: m_nodes) { node.second->update(); }
-        // Remove "toDelete" nodes
-        for (auto iter = m_nodes.begin(); iter != m_nodes.end();) {
-            if (iter->second->toDestroy())
-                iter = m_nodes.erase(iter);
+        bool simplified = m_style.lod_simplified_nodes > 0.f && m_context.scale() < m_style.lod_simplified_nodes;
+        ImVec2 viewMin = screen2grid(gridPos);
+        ImVec2 viewMax = screen2grid(gridPos + gridSize);
+        auto culled = [&](BaseNode *node) {
+            // Nodes never drawn have no size yet
+            if (!m_culling || node->isSelected() || node->isDragged() || node->getFullSize().x == 0.f)
+                return false;
+            const ImVec4 &padding = node->getStyle()->padding;
+            ImVec2 min = node->getPos() - ImVec2(padding.x, padding.y);
+            ImVec2 max = min + node->getFullSize();
+            return max.x < viewMin.x || max.y < viewMin.y || min.x > viewMax.x || min.y > viewMax.y;
+        };
+        m_context.pushScale();
+        // Back to front, by index as nodes can be added meanwhile
+        for (size_t i = 0; i < m_zOrder.size(); i++) {
+            std::shared_ptr<BaseNode> *found = m_nodes.get(m_zOrder[i]);
+            if (!found)
+                continue;
+            BaseNode *node = found->get();
+            if (culled(node))
+                node->updateCulled();
+            else if (simplified && node->getFullSize().x != 0.f)
+                node->updateSimplified();
             else
-                ++iter;
+                node->update();
         }
+        m_context.popScale();
+        // Remove "toDelete" nodes, and the handles of nodes removed meanwhile
+        m_zOrder.erase(std::remove_if(m_zOrder.begin(), m_zOrder.end(), [this](NodeUID uid) {
+            std::shared_ptr<BaseNode> *found = m_nodes.get(uid);
+            if (!found)
+                return true;
+            BaseNode *node = found->get();
+            if (!node->toDestroy())
+                return false;
+            m_nodeIndex.remove(node);
+            m_nodes.erase(uid);
+            invalidateEvaluationPlan();
+            return true;
+        }), m_zOrder.end());
+        applyRaised();
         draw_list->ChannelsMerge();
-        for (auto &node: m_nodes) { node.second->updatePublicStatus(); }
+        for (auto &node: m_nodes) { node->updatePublicStatus(); }
 
         // Update and draw links
         for (auto &l: m_links) { if (!l.expired()) l.lock()->update(); }
@@ -298,18 +1104,30 @@ namespace ImFlow {
         }
 
         // Links drag-out
-        if (!m_draggingNode && m_hovering && !m_dragOut && ImGui::IsMouseClicked(ImGuiMouseButton_Left))
+        if (!m_draggingNode && m_hovering && !m_dragOut && ImGui::IsMouseClicked(ImGuiMouseButton_Left)) {
             m_dragOut = m_hovering;
+            // Nodes the dragged link can't reach without closing a cycle
+            m_dragBlocked.clear();
+            if (m_rejectCycles) {
+                if (!m_topoValid)
+                    rebuildTopologicalOrder();
+                bool downstream = m_dragOut->getType() == PinType_Input;
+                collectReachable(m_dragOut->getParent(), downstream, downstream ? UINT32_MAX : 0, nullptr, m_topoForward);
+                m_dragBlocked.insert(m_topoForward.begin(), m_topoForward.end());
+            }
+        }
         if (m_dragOut) {
             if (m_dragOut->getType() == PinType_Output)
                 smart_bezier(m_dragOut->pinPoint(), ImGui::GetMousePos(), m_dragOut->getStyle()->color,
-                             m_dragOut->getStyle()->extra.link_dragged_thickness);
+                             m_dragOut->getStyle()->extra.link_dragged_thickness * s);
             else
                 smart_bezier(ImGui::GetMousePos(), m_dragOut->pinPoint(), m_dragOut->getStyle()->color,
-                             m_dragOut->getStyle()->extra.link_dragged_thickness);
+                             m_dragOut->getStyle()->extra.link_dragged_thickness * s);
 
-            if (ImGui::IsMouseReleased(ImGuiMouseButton_Left))
+            if (ImGui::IsMouseReleased(ImGuiMouseButton_Left)) {
                 m_dragOut = nullptr;
+                m_dragBlocked.clear();
+            }
         }
 
         // Right-click PopUp
@@ -332,8 +1150,10 @@ namespace ImFlow {
         m_links.erase(std::remove_if(m_links.begin(), m_links.end(),
                                      [](const std::weak_ptr<Link> &l) { return l.expired(); }), m_links.end());
 
-        // Clearing recursion blacklist
-        m_pinRecursionBlacklist.clear();
+        // New evaluation epoch
+        m_evalEpoch++;
+        if (m_profiling)
+            profilerNextFrame();
 
         m_context.end();
     }
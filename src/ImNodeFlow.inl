@@ -4,9 +4,8 @@
 
 namespace ImFlow
 {
-    inline void smart_bezier(const ImVec2& p1, const ImVec2& p2, ImU32 color, float thickness)
+    inline ImCubicBezierPoints smart_bezier_points(const ImVec2& p1, const ImVec2& p2)
     {
-        ImDrawList* dl = ImGui::GetWindowDrawList();
         float distance = sqrt(pow((p2.x - p1.x), 2.f) + pow((p2.y - p1.y), 2.f));
         float delta = distance * 0.45f;
         if (p2.x < p1.x) delta += 0.2f * (p1.x - p2.x);
@@ -15,20 +14,18 @@ namespace ImFlow
         ImVec2 p22 = p2 - ImVec2(delta, vert);
         if (p2.x < p1.x - 50.f) delta *= -1.f;
         ImVec2 p11 = p1 + ImVec2(delta, vert);
-        dl->AddBezierCubic(p1, p11, p22, p2, color, thickness);
+        return {p1, p11, p22, p2};
+    }
+
+    inline void smart_bezier(const ImVec2& p1, const ImVec2& p2, ImU32 color, float thickness)
+    {
+        ImCubicBezierPoints c = smart_bezier_points(p1, p2);
+        ImGui::GetWindowDrawList()->AddBezierCubic(c.P0, c.P1, c.P2, c.P3, color, thickness);
     }
 
     inline bool smart_bezier_collider(const ImVec2& p, const ImVec2& p1, const ImVec2& p2, float radius)
     {
-        float distance = sqrt(pow((p2.x - p1.x), 2.f) + pow((p2.y - p1.y), 2.f));
-        float delta = distance * 0.45f;
-        if (p2.x < p1.x) delta += 0.2f * (p1.x - p2.x);
-        // float vert = (p2.x < p1.x - 20.f) ? 0.062f * distance * (p2.y - p1.y) * 0.005f : 0.f;
-        float vert = 0.f;
-        ImVec2 p22 = p2 - ImVec2(delta, vert);
-        if (p2.x < p1.x - 50.f) delta *= -1.f;
-        ImVec2 p11 = p1 + ImVec2(delta, vert);
-        return ImProjectOnCubicBezier(p, p1, p11, p22, p2).Distance < radius;
+        return ImProjectOnCubicBezier(p, smart_bezier_points(p1, p2)).Distance < radius;
     }
 
     // -----------------------------------------------------------------------------------------------------------------
@@ -39,15 +36,22 @@ namespace ImFlow
     {
         static_assert(std::is_base_of<BaseNode, T>::value, "Pushed type is not a subclass of BaseNode!");
 
-        std::shared_ptr<T> n = std::make_shared<T>(std::forward<Params>(args)...);
+        std::shared_ptr<T> n;
+        {
+            // Pins added by the constructor come from the same resource
+            ScopedMemoryResource scope(m_memory);
+            n = allocateShared<T>(m_memory, MemoryKind_Node, std::forward<Params>(args)...);
+        }
         n->setPos(pos);
         n->setHandler(this);
         if (!n->getStyle())
             n->setStyle(NodeStyle::cyan());
 
-        auto uid = reinterpret_cast<uintptr_t>(n.get());
+        NodeUID uid = m_nodes.insert(n);
         n->setUID(uid);
-        m_nodes[uid] = n;
+        n->setTopologicalOrder(m_topoNext++);
+        m_zOrder.push_back(uid);
+        invalidateEvaluationPlan();
         return n;
     }
 
@@ -67,17 +71,19 @@ namespace ImFlow
     // BASE NODE
 
     template<typename T>
-    std::shared_ptr<InPin<T>> BaseNode::addIN(const std::string& name, T defReturn, std::function<bool(Pin*, Pin*)> filter, std::shared_ptr<PinStyle> style)
+    std::shared_ptr<InPin<T>> BaseNode::addIN(const std::string& name, T defReturn, std::function<bool(Pin*, Pin*)> filter, std::shared_ptr<const PinStyle> style)
     {
-        return addIN_uid(name, name, defReturn, std::move(filter), std::move(style));
+        return addIN_uid(name, name, std::move(defReturn), std::move(filter), std::move(style));
     }
 
     template<typename T, typename U>
-    std::shared_ptr<InPin<T>> BaseNode::addIN_uid(const U& uid, const std::string& name, T defReturn, std::function<bool(Pin*, Pin*)> filter, std::shared_ptr<PinStyle> style)
+    std::shared_ptr<InPin<T>> BaseNode::addIN_uid(const U& uid, const std::string& name, T defReturn, std::function<bool(Pin*, Pin*)> filter, std::shared_ptr<const PinStyle> style)
     {
         PinUID h = std::hash<U>{}(uid);
-        auto p = std::make_shared<InPin<T>>(h, name, defReturn, std::move(filter), std::move(style), this, &m_inf);
+        auto p = allocateShared<InPin<T>>(memoryResource(), MemoryKind_Pin, h, name, std::move(defReturn), std::move(filter), std::move(style), this, &m_inf);
         m_ins.emplace_back(p);
+        if (m_inf)
+            m_inf->invalidateEvaluationPlan();
         return p;
     }
 
@@ -90,6 +96,8 @@ namespace ImFlow
             if (it->get()->getUid() == h)
             {
                 m_ins.erase(it);
+                if (m_inf)
+                    m_inf->invalidateEvaluationPlan();
                 return;
             }
         }
@@ -101,40 +109,37 @@ namespace ImFlow
     }
 
     template<typename T>
-    const T& BaseNode::showIN(const std::string& name, T defReturn, std::function<bool(Pin*, Pin*)> filter, std::shared_ptr<PinStyle> style)
+    const T& BaseNode::showIN(const std::string& name, T defReturn, std::function<bool(Pin*, Pin*)> filter, std::shared_ptr<const PinStyle> style)
     {
-        return showIN_uid(name, name, defReturn, std::move(filter), std::move(style));
+        return showIN_uid(name, name, std::move(defReturn), std::move(filter), std::move(style));
     }
 
     template<typename T, typename U>
-    const T& BaseNode::showIN_uid(const U& uid, const std::string& name, T defReturn, std::function<bool(Pin*, Pin*)> filter, std::shared_ptr<PinStyle> style)
+    const T& BaseNode::showIN_uid(const U& uid, const std::string& name, T defReturn, std::function<bool(Pin*, Pin*)> filter, std::shared_ptr<const PinStyle> style)
     {
         PinUID h = std::hash<U>{}(uid);
-        for (std::pair<int, std::shared_ptr<Pin>>& p : m_dynamicIns)
-        {
-            if (p.second->getUid() == h)
-            {
-                p.first = 1;
-                return static_cast<InPin<T>*>(p.second.get())->val();
-            }
-        }
+        if (Pin* p = showDynamic(m_dynamicIns, m_dynamicInsIndex, h))
+            return static_cast<InPin<T>*>(p)->val();
 
-        m_dynamicIns.emplace_back(std::make_pair(1, std::make_shared<InPin<T>>(h, name, defReturn, std::move(filter), std::move(style), this, &m_inf)));
-        return static_cast<InPin<T>*>(m_dynamicIns.back().second.get())->val();
+        auto p = allocateShared<InPin<T>>(memoryResource(), MemoryKind_Pin, h, name, std::move(defReturn), std::move(filter), std::move(style), this, &m_inf);
+        addDynamic(m_dynamicIns, m_dynamicInsIndex, p);
+        return p->val();
     }
 
     template<typename T>
-    std::shared_ptr<OutPin<T>> BaseNode::addOUT(const std::string& name, std::shared_ptr<PinStyle> style)
+    std::shared_ptr<OutPin<T>> BaseNode::addOUT(const std::string& name, std::shared_ptr<const PinStyle> style)
     {
         return addOUT_uid<T>(name, name, std::move(style));
     }
 
     template<typename T, typename U>
-    std::shared_ptr<OutPin<T>> BaseNode::addOUT_uid(const U& uid, const std::string& name, std::shared_ptr<PinStyle> style)
+    std::shared_ptr<OutPin<T>> BaseNode::addOUT_uid(const U& uid, const std::string& name, std::shared_ptr<const PinStyle> style)
     {
         PinUID h = std::hash<U>{}(uid);
-        auto p = std::make_shared<OutPin<T>>(h, name, std::move(style), this, &m_inf);
+        auto p = allocateShared<OutPin<T>>(memoryResource(), MemoryKind_Pin, h, name, std::move(style), this, &m_inf);
         m_outs.emplace_back(p);
+        if (m_inf)
+            m_inf->invalidateEvaluationPlan();
         return p;
     }
 
@@ -147,6 +152,8 @@ namespace ImFlow
             if (it->get()->getUid() == h)
             {
                 m_outs.erase(it);
+                if (m_inf)
+                    m_inf->invalidateEvaluationPlan();
                 return;
             }
         }
@@ -158,27 +165,24 @@ namespace ImFlow
     }
 
     template<typename T>
-    void BaseNode::showOUT(const std::string& name, std::function<T()> behaviour, std::shared_ptr<PinStyle> style)
+    void BaseNode::showOUT(const std::string& name, std::function<T()> behaviour, std::shared_ptr<const PinStyle> style)
     {
         showOUT_uid<T>(name, name, std::move(behaviour), std::move(style));
     }
 
     template<typename T, typename U>
-    void BaseNode::showOUT_uid(const U& uid, const std::string& name, std::function<T()> behaviour, std::shared_ptr<PinStyle> style)
+    void BaseNode::showOUT_uid(const U& uid, const std::string& name, std::function<T()> behaviour, std::shared_ptr<const PinStyle> style)
     {
         PinUID h = std::hash<U>{}(uid);
-        for (std::pair<int, std::shared_ptr<Pin>>& p : m_dynamicOuts)
+        if (Pin* p = showDynamic(m_dynamicOuts, m_dynamicOutsIndex, h))
         {
-            if (p.second->getUid() == h)
-            {
-                p.first = 2;
-                static_cast<OutPin<T>*>(m_dynamicOuts.back().second.get())->behaviour(std::move(behaviour));
-                return;
-            }
+            static_cast<OutPin<T>*>(p)->behaviour(std::move(behaviour));
+            return;
         }
 
-        m_dynamicOuts.emplace_back(std::make_pair(2, std::make_shared<OutPin<T>>(h, name, std::move(style), this, &m_inf)));
-        static_cast<OutPin<T>*>(m_dynamicOuts.back().second.get())->behaviour(std::move(behaviour));
+        auto p = allocateShared<OutPin<T>>(memoryResource(), MemoryKind_Pin, h, name, std::move(style), this, &m_inf);
+        addDynamic(m_dynamicOuts, m_dynamicOutsIndex, p);
+        p->behaviour(std::move(behaviour));
     }
 
     template<typename T, typename U>
@@ -197,6 +201,15 @@ namespace ImFlow
         return getInVal<T, std::string>(uid);
     }
 
+    template<typename T>
+    const T& BaseNode::getInVal(InPinHandle<T> pin)
+    {
+        InPin<T>* p = pinAt(m_ins, pin);
+        if (!p)
+            throw std::out_of_range("Pin handle doesn't resolve to an input of the node");
+        return p->val();
+    }
+
     template<typename U>
     Pin* BaseNode::inPin(const U& uid)
     {
@@ -227,23 +240,117 @@ namespace ImFlow
         return outPin<std::string>(uid);
     }
 
+    inline Pin* BaseNode::showDynamic(std::vector<std::pair<uint32_t, std::shared_ptr<Pin>>>& pins, std::unordered_map<PinUID, uint32_t>& index, PinUID uid)
+    {
+        auto it = index.find(uid);
+        if (it == index.end())
+            return nullptr;
+        std::pair<uint32_t, std::shared_ptr<Pin>>& p = pins[it->second];
+        if (p.first != m_dynamicGeneration)
+        {
+            p.first = m_dynamicGeneration;
+            m_dynamicShown++;
+        }
+        return p.second.get();
+    }
+
+    inline void BaseNode::addDynamic(std::vector<std::pair<uint32_t, std::shared_ptr<Pin>>>& pins, std::unordered_map<PinUID, uint32_t>& index, std::shared_ptr<Pin> pin)
+    {
+        index.emplace(pin->getUid(), (uint32_t)pins.size());
+        pins.emplace_back(m_dynamicGeneration, std::move(pin));
+        m_dynamicShown++;
+        if (m_inf)
+            m_inf->invalidateEvaluationPlan();
+    }
+
+    template<typename P>
+    P* BaseNode::pinAt(const std::vector<std::shared_ptr<Pin>>& pins, PinHandle<P> pin)
+    {
+        if (!pin.valid())
+            return nullptr;
+
+        // Checked cast: the pin may have been dropped and added again at the same index with another type
+        if (pin.index() < pins.size() && pins[pin.index()]->getUid() == pin.uid())
+            return dynamic_cast<P*>(pins[pin.index()].get());
+
+        // Moved by the drop of a pin added before it, or dropped and added again with another type
+        PinUID h = pin.uid();
+        auto it = std::find_if(pins.begin(), pins.end(), [h](const std::shared_ptr<Pin>& q) { return q->getUid() == h; });
+        return it != pins.end() ? dynamic_cast<P*>(it->get()) : nullptr;
+    }
+
+    // -----------------------------------------------------------------------------------------------------------------
+    // PIN HANDLE
+
+    template<typename P>
+    PinHandle<P>::PinHandle(const std::shared_ptr<P>& pin)
+        :m_uid(pin->getUid())
+    {
+        BaseNode* node = pin->getParent();
+        const std::vector<std::shared_ptr<Pin>>& pins = pin->getType() == PinType_Input ? node->getIns() : node->getOuts();
+        // Handles are usually made right after addIN()/addOUT(), the pin is at the end
+        for (size_t i = pins.size(); i-- > 0;)
+        {
+            if (pins[i].get() == pin.get())
+            {
+                m_index = (uint32_t)i;
+                return;
+            }
+        }
+        // Dynamic pin, the handle stays invalid
+    }
+
+    // -----------------------------------------------------------------------------------------------------------------
+    // PROFILER
+
+    inline ProfilerScope::ProfilerScope(BaseNode* node, bool draw)
+        :m_node(node), m_draw(draw), m_outerChildTime(s_childTime), m_start(std::chrono::steady_clock::now())
+    {
+        s_childTime = 0.0;
+    }
+
+    inline ProfilerScope::~ProfilerScope()
+    {
+        double inclusive = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - m_start).count();
+        double self = inclusive - s_childTime;
+        if (m_draw)
+            m_node->profileSample().draw += self;
+        else
+            m_node->recordEvaluation(inclusive, self);
+        s_childTime = m_outerChildTime + inclusive;
+    }
+
     // -----------------------------------------------------------------------------------------------------------------
     // PIN
 
     inline void Pin::drawSocket()
     {
         ImDrawList* draw_list = ImGui::GetWindowDrawList();
-        ImVec2 tl = pinPoint() - ImVec2(m_style->socket_radius, m_style->socket_radius);
-        ImVec2 br = pinPoint() + ImVec2(m_style->socket_radius, m_style->socket_radius);
+        float s = (*m_inf)->getDrawScale();
+        ImVec2 tl = pinPoint() - ImVec2(m_style->socket_radius, m_style->socket_radius) * s;
+        ImVec2 br = pinPoint() + ImVec2(m_style->socket_radius, m_style->socket_radius) * s;
+        // Greyed out when the dragged link can't connect here
+        ImU32 color = (*m_inf)->isLinkTargetBlocked(this) ? (*m_inf)->getStyle().colors.blockedPin : m_style->color;
 
         if (isConnected())
-            draw_list->AddCircleFilled(pinPoint(), m_style->socket_connected_radius, m_style->color, m_style->socket_shape);
+            draw_list->AddCircleFilled(pinPoint(), m_style->socket_connected_radius * s, color, m_style->socket_shape);
         else
         {
             if (ImGui::IsItemHovered() || ImGui::IsMouseHoveringRect(tl, br))
-                draw_list->AddCircle(pinPoint(), m_style->socket_hovered_radius, m_style->color, m_style->socket_shape, m_style->socket_thickness);
+                draw_list->AddCircle(pinPoint(), m_style->socket_hovered_radius * s, color, m_style->socket_shape, m_style->socket_thickness * s);
             else
-                draw_list->AddCircle(pinPoint(), m_style->socket_radius, m_style->color, m_style->socket_shape, m_style->socket_thickness);
+                draw_list->AddCircle(pinPoint(), m_style->socket_radius * s, color, m_style->socket_shape, m_style->socket_thickness * s);
+        }
+
+        // Spinner while the value is being calculated in the background, ring if that failed
+        PinState state = getState();
+        if (state == PinState_Error)
+            draw_list->AddCircle(pinPoint(), (m_style->socket_hovered_radius + 2.f) * s, (*m_inf)->getStyle().colors.errorPin, 0, m_style->socket_thickness * s);
+        else if (state != PinState_Ready)
+        {
+            float a = (float)ImGui::GetTime() * 6.f;
+            draw_list->PathArcTo(pinPoint(), (m_style->socket_hovered_radius + 2.f) * s, a, a + IM_PI * 1.5f);
+            draw_list->PathStroke(m_style->color, 0, m_style->socket_thickness * s);
         }
 
         if (ImGui::IsMouseHoveringRect(tl, br))
@@ -253,12 +360,14 @@ namespace ImFlow
     inline void Pin::drawDecoration()
     {
         ImDrawList* draw_list = ImGui::GetWindowDrawList();
+        float s = (*m_inf)->getDrawScale();
+        ImVec2 padding = m_style->extra.padding * s;
 
         if (ImGui::IsItemHovered())
-            draw_list->AddRectFilled(m_pos - m_style->extra.padding, m_pos + m_size + m_style->extra.padding, m_style->extra.bg_hover_color, m_style->extra.bg_radius);
+            draw_list->AddRectFilled(m_pos - padding, m_pos + m_size + padding, m_style->extra.bg_hover_color, m_style->extra.bg_radius * s);
         else
-            draw_list->AddRectFilled(m_pos - m_style->extra.padding, m_pos + m_size + m_style->extra.padding, m_style->extra.bg_color, m_style->extra.bg_radius);
-        draw_list->AddRect(m_pos - m_style->extra.padding, m_pos + m_size + m_style->extra.padding, m_style->extra.border_color, m_style->extra.bg_radius, 0, m_style->extra.border_thickness);
+            draw_list->AddRectFilled(m_pos - padding, m_pos + m_size + padding, m_style->extra.bg_color, m_style->extra.bg_radius * s);
+        draw_list->AddRect(m_pos - padding, m_pos + m_size + padding, m_style->extra.border_color, m_style->extra.bg_radius * s, 0, m_style->extra.border_thickness * s);
     }
 
     inline void Pin::update()
@@ -275,7 +384,7 @@ namespace ImFlow
             return;
         }
 
-        ImGui::SetCursorPos(m_pos);
+        ImGui::SetCursorScreenPos(m_pos);
         ImGui::Text("%s", m_name.c_str());
         m_size = ImGui::GetItemRectSize();
 
@@ -309,16 +418,32 @@ namespace ImFlow
 
         if (m_link && m_link->left() == other)
         {
-            m_link.reset();
+            deleteLink();
             return;
         }
 
         if (!m_filter(other, this)) // Check Filter
             return;
 
-        m_link = std::make_shared<Link>(other, this, (*m_inf));
+        if ((*m_inf)->isRejectingCycles() && (*m_inf)->wouldCreateCycle(other, this))
+            return;
+
+        m_link = allocateShared<Link>((*m_inf)->getMemoryResource(), MemoryKind_Link, other, this, (*m_inf));
         other->setLink(m_link);
         (*m_inf)->addLink(m_link);
+        (*m_inf)->linkTopologicalOrder(other->getParent(), m_parent);
+        (*m_inf)->invalidateEvaluationPlan();
+        m_parent->markDirty();
+    }
+
+    template<class T>
+    void InPin<T>::deleteLink()
+    {
+        m_link.reset();
+        // The node may outlive its handler
+        if (*m_inf)
+            (*m_inf)->invalidateEvaluationPlan();
+        m_parent->markDirty();
     }
 
     // -----------------------------------------------------------------------------------------------------------------
@@ -327,16 +452,159 @@ namespace ImFlow
     template<class T>
     const T &OutPin<T>::val()
     {
-        std::string s = std::to_string(m_uid) + std::to_string(m_parent->getUID());
-        if (std::find((*m_inf)->get_recursion_blacklist().begin(), (*m_inf)->get_recursion_blacklist().end(), s) == (*m_inf)->get_recursion_blacklist().end())
+        // Flagged before running the behaviour, so a cycle leading back here gets the cached value
+        bool incremental = (*m_inf)->isIncremental();
+        bool outdated = incremental ? m_dirty && !m_evaluating : m_epoch != (*m_inf)->getEvaluationEpoch();
+        // An asynchronous pin stays outdated until the running job is collected
+        if (outdated && !m_future.valid())
         {
-            (*m_inf)->get_recursion_blacklist().emplace_back(s);
-            m_val = m_behaviour();
+            uint64_t previous = m_epoch;
+            m_epoch = (*m_inf)->getEvaluationEpoch();
+            m_evaluating = true;
+            std::optional<ProfilerScope> profile;
+            if ((*m_inf)->isProfiling())
+                profile.emplace(m_parent, false);
+            try
+            {
+                // Without dirtiness tracking, a job is only started again when what it reads has changed
+                bool relaunch = true;
+                if (m_asyncBehaviour && !incremental)
+                {
+                    uint64_t inputs = inputsVersion();
+                    relaunch = m_dirty || inputs != m_inputsVersion;
+                    m_inputsVersion = inputs;
+                }
+                if (m_dirty)
+                {
+                    m_dirty = false;
+                    cleanCount()++;
+                }
+                if (relaunch)
+                    runBehaviour();
+            }
+            catch (...)
+            {
+                // Evaluated again next time instead of serving a value never computed
+                m_evaluating = false;
+                m_dirty = true;
+                m_epoch = previous;
+                throw;
+            }
+            m_evaluating = false;
         }
 
         return m_val;
     }
 
+    template<class T>
+    void OutPin<T>::runBehaviour()
+    {
+        if (m_asyncBehaviour)
+        {
+            // Exceptions thrown by the job are stored in the future
+            auto job = std::make_shared<std::packaged_task<T()>>(m_asyncBehaviour());
+            m_future = job->get_future();
+            (*m_inf)->submitJob([job]() { (*job)(); });
+            (*m_inf)->addPendingJobs(1);
+        }
+        else if (m_inPlaceBehaviour)
+        {
+            m_inPlaceBehaviour(m_val);
+            m_version++;
+        }
+        else
+        {
+            T val = m_behaviour();
+            // Unchanged values keep their version, so the asynchronous pins reading them aren't restarted
+            if (m_hasVal && sameValue(val, m_val))
+                return;
+            m_val = std::move(val);
+            m_hasVal = true;
+            m_version++;
+        }
+    }
+
+    template<class T>
+    bool OutPin<T>::sameValue(const T& a, const T& b)
+    {
+        if constexpr (std::is_trivially_copyable<T>::value)
+            return std::memcmp(&a, &b, sizeof(T)) == 0;
+        else if constexpr (IsComparable<T>::value)
+            return a == b;
+        else
+            return false;
+    }
+
+    template<class T>
+    void OutPin<T>::poll()
+    {
+        if (!m_future.valid() || m_future.wait_for(std::chrono::seconds(0)) != std::future_status::ready)
+            return;
+
+        (*m_inf)->addPendingJobs(-1);
+        (*m_inf)->requestRedraw();
+        try
+        {
+            T val = m_future.get();
+            m_error = nullptr;
+            if (m_hasVal && sameValue(val, m_val))
+                return;
+            m_val = std::move(val);
+        }
+        catch (...)
+        {
+            m_error = std::current_exception();
+            return;
+        }
+        m_hasVal = true;
+        m_version++;
+        for (auto& l : m_links)
+            if (auto link = l.lock())
+                link->right()->getParent()->markDirty();
+    }
+
+    template<class T>
+    PinState OutPin<T>::getState()
+    {
+        if (m_future.valid())
+            return m_hasVal ? PinState_Stale : PinState_Pending;
+        return m_error ? PinState_Error : PinState_Ready;
+    }
+
+    template<class T>
+    uint64_t OutPin<T>::inputsVersion()
+    {
+        // FNV-1a over the versions, after bringing the connected outputs up to date
+        uint64_t h = 14695981039346656037ull;
+        auto add = [&](Pin* p) {
+            if (auto link = p->getLink().lock())
+                link->left()->resolve();
+            h = (h ^ p->getVersion()) * 1099511628211ull;
+        };
+        for (auto& p : m_parent->getIns())
+            add(p.get());
+        for (auto& p : m_parent->getDynamicIns())
+            add(p.second.get());
+        return h;
+    }
+
+    template<class T>
+    void OutPin<T>::propagateDirty(uint64_t walk)
+    {
+        // Not stopping on m_dirty alone: a pin can be dirty while the nodes downstream were evaluated without pulling it.
+        // If no pin became clean since the last walk through here, though, they are all still dirty.
+        uint64_t cleaned = cleanCount().load();
+        if (m_dirtyWalk == walk || (m_dirty && m_dirtySince == cleaned))
+            return;
+
+        m_dirtyWalk = walk;
+        m_dirtySince = cleaned;
+        m_dirty = true;
+        for (auto& l : m_links)
+            if (auto link = l.lock())
+                link->right()->getParent()->propagateDirty(walk);
+    }
+
     template<class T>
     void OutPin<T>::createLink(ImFlow::Pin *other)
     {
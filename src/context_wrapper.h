@@ -1,8 +1,15 @@
 #pragma once
 
+#include <cstddef>
+#include <cstring>
 #include <imgui.h>
 #include <imgui_internal.h>
 
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define IMNODEFLOW_DRAW_SSE2
+#endif
+
 inline static void CopyIOEvents(ImGuiContext* src, ImGuiContext* dst, ImVec2 origin, float scale)
 {
     dst->PlatformImeData = src->PlatformImeData;
@@ -16,40 +23,120 @@ inline static void CopyIOEvents(ImGuiContext* src, ImGuiContext* dst, ImVec2 ori
     }
 }
 
-inline static void AppendDrawData(ImDrawList* src, ImVec2 origin, float scale)
+inline static void TransformVertices(const ImDrawVert* src, ImDrawVert* dst, int count, ImVec2 origin, float scale)
+{
+    if (scale == 1.f && origin.x == 0.f && origin.y == 0.f)
+    {
+        if (count > 0)
+            memcpy(dst, src, (size_t)count * sizeof(ImDrawVert));
+        return;
+    }
+
+    int i = 0;
+#ifdef IMNODEFLOW_DRAW_SSE2
+    // With the default layout 4 vertices fill 5 registers, with the positions always in the same lanes.
+    // The other lanes are blended back bitwise, so uvs and colors never go through float math.
+    if (sizeof(ImDrawVert) == 20 && offsetof(ImDrawVert, pos) == 0)
+    {
+        const __m128 m0 = _mm_castsi128_ps(_mm_set_epi32(0, 0, -1, -1));
+        const __m128 m1 = _mm_castsi128_ps(_mm_set_epi32(0, -1, -1, 0));
+        const __m128 m2 = _mm_castsi128_ps(_mm_set_epi32(-1, -1, 0, 0));
+        const __m128 m3 = _mm_castsi128_ps(_mm_set_epi32(-1, 0, 0, 0));
+        const __m128 m4 = _mm_castsi128_ps(_mm_set_epi32(0, 0, 0, -1));
+        const __m128 xy = _mm_set_ps(origin.y, origin.x, origin.y, origin.x);
+        const __m128 yx = _mm_set_ps(origin.x, origin.y, origin.x, origin.y);
+        const __m128 k = _mm_set1_ps(scale);
+        auto lanes = [&](const float* in, float* out, __m128 mask, __m128 offset) {
+            __m128 v = _mm_loadu_ps(in);
+            __m128 t = _mm_add_ps(_mm_mul_ps(v, k), offset);
+            _mm_storeu_ps(out, _mm_or_ps(_mm_and_ps(mask, t), _mm_andnot_ps(mask, v)));
+        };
+        for (; i + 4 <= count; i += 4)
+        {
+            const float* in = reinterpret_cast<const float*>(src + i);
+            float* out = reinterpret_cast<float*>(dst + i);
+            lanes(in, out, m0, xy);
+            lanes(in + 4, out + 4, m1, yx);
+            lanes(in + 8, out + 8, m2, xy);
+            lanes(in + 12, out + 12, m3, yx);
+            lanes(in + 16, out + 16, m4, yx);
+        }
+    }
+#endif
+    for (; i < count; ++i) {
+        dst[i].uv = src[i].uv;
+        dst[i].col = src[i].col;
+        dst[i].pos = src[i].pos * scale + origin;
+    }
+}
+
+inline static void RebaseIndices(const ImDrawIdx* src, ImDrawIdx* dst, int count, unsigned int base)
+{
+    if (base == 0)
+    {
+        if (count > 0)
+            memcpy(dst, src, (size_t)count * sizeof(ImDrawIdx));
+        return;
+    }
+
+    int i = 0;
+#ifdef IMNODEFLOW_DRAW_SSE2
+    const int lanes = 16 / (int)sizeof(ImDrawIdx);
+    const __m128i b = sizeof(ImDrawIdx) == 2 ? _mm_set1_epi16((short)base) : _mm_set1_epi32((int)base);
+    for (; i + lanes <= count; i += lanes)
+    {
+        __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i));
+        v = sizeof(ImDrawIdx) == 2 ? _mm_add_epi16(v, b) : _mm_add_epi32(v, b);
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i), v);
+    }
+#endif
+    for (; i < count; ++i)
+        dst[i] = (ImDrawIdx)(src[i] + base);
+}
+
+#undef IMNODEFLOW_DRAW_SSE2
+
+inline static void AppendDrawData(const ImVector<ImDrawVert>& vtx, const ImVector<ImDrawIdx>& idx, const ImVector<ImDrawCmd>& cmds, ImVec2 origin, float scale)
 {
-    // TODO optimize if vtx_start == 0 || if idx_start == 0
     ImDrawList* dl = ImGui::GetWindowDrawList();
     const int vtx_start = dl->VtxBuffer.size();
     const int idx_start = dl->IdxBuffer.size();
-    dl->VtxBuffer.resize(dl->VtxBuffer.size() + src->VtxBuffer.size());
-    dl->IdxBuffer.resize(dl->IdxBuffer.size() + src->IdxBuffer.size());
-    dl->CmdBuffer.reserve(dl->CmdBuffer.size() + src->CmdBuffer.size());
-    dl->_VtxWritePtr = dl->VtxBuffer.Data + vtx_start;
-    dl->_IdxWritePtr = dl->IdxBuffer.Data + idx_start;
-    const ImDrawVert* vtx_read = src->VtxBuffer.Data;
-    const ImDrawIdx* idx_read = src->IdxBuffer.Data;
-    for (int i = 0, c = src->VtxBuffer.size(); i < c; ++i) {
-        dl->_VtxWritePtr[i].uv = vtx_read[i].uv;
-        dl->_VtxWritePtr[i].col = vtx_read[i].col;
-        dl->_VtxWritePtr[i].pos = vtx_read[i].pos * scale + origin;
-    }
-    for (int i = 0, c = src->IdxBuffer.size(); i < c; ++i) {
-        dl->_IdxWritePtr[i] = idx_read[i] + vtx_start;
-    }
-    for (auto cmd : src->CmdBuffer) {
+    const int cmd_start = dl->CmdBuffer.size();
+    // When the renderer supports it, the commands are offset instead of rewriting every index
+    const bool vtx_offset = (ImGui::GetIO().BackendFlags & ImGuiBackendFlags_RendererHasVtxOffset) != 0;
+    dl->VtxBuffer.resize(vtx_start + vtx.size());
+    dl->IdxBuffer.resize(idx_start + idx.size());
+    dl->CmdBuffer.resize(cmd_start + cmds.size());
+
+    TransformVertices(vtx.Data, dl->VtxBuffer.Data + vtx_start, vtx.size(), origin, scale);
+    RebaseIndices(idx.Data, dl->IdxBuffer.Data + idx_start, idx.size(), vtx_offset ? 0 : vtx_start);
+
+    ImDrawCmd* cmd_write = dl->CmdBuffer.Data + cmd_start;
+    for (int i = 0, c = cmds.size(); i < c; ++i) {
+        ImDrawCmd& cmd = cmd_write[i];
+        cmd = cmds[i];
         cmd.IdxOffset += idx_start;
-        IM_ASSERT(cmd.VtxOffset == 0);
+        if (vtx_offset)
+            cmd.VtxOffset += vtx_start;
+        else
+            IM_ASSERT(cmd.VtxOffset == 0);
         cmd.ClipRect.x = cmd.ClipRect.x * scale + origin.x;
         cmd.ClipRect.y = cmd.ClipRect.y * scale + origin.y;
         cmd.ClipRect.z = cmd.ClipRect.z * scale + origin.x;
         cmd.ClipRect.w = cmd.ClipRect.w * scale + origin.y;
-        dl->CmdBuffer.push_back(cmd);
     }
 
-    dl->_VtxCurrentIdx += src->VtxBuffer.size();
+    dl->_VtxCurrentIdx += vtx.size();
     dl->_VtxWritePtr = dl->VtxBuffer.Data + dl->VtxBuffer.size();
     dl->_IdxWritePtr = dl->IdxBuffer.Data + dl->IdxBuffer.size();
+    // Following primitives of the parent must not end up in the last appended command
+    if (!cmds.empty())
+        dl->AddDrawCmd();
+}
+
+inline static void AppendDrawData(ImDrawList* src, ImVec2 origin, float scale)
+{
+    AppendDrawData(src->VtxBuffer, src->IdxBuffer, src->CmdBuffer, origin, scale);
 }
 
 struct ContainedContextConfig
@@ -65,6 +152,14 @@ struct ContainedContextConfig
     float default_zoom = 1.f;
     ImGuiKey reset_zoom_key = ImGuiKey_R;
     ImGuiMouseButton scroll_button = ImGuiMouseButton_Middle;
+    // Replay the last frame instead of running the inner frame when nothing happened
+    // Time based content (tooltip delays, animations) needs requestRedraw()
+    bool idle_skip = false;
+    // Frames still fully processed after the last activity, to let the inner frame settle
+    int idle_settle_frames = 3;
+    // Draw into the parent context at scale (scaled style and font) instead of a nested context
+    // The content must place itself in screen space and scale its own sizes by drawScale()
+    bool direct = false;
 };
 
 class ContainedContext
@@ -72,10 +167,19 @@ class ContainedContext
 public:
     ~ContainedContext();
     ContainedContextConfig& config() { return m_config; }
-    void begin();
+    [[nodiscard]] const ContainedContextConfig& config() const { return m_config; }
+    // Returns false when the frame is idle and replayed, the content must be skipped (end() must still be called)
+    bool begin();
     void end();
+    // Scale the style and font of the parent context for the content, only in direct mode
+    void pushScale();
+    void popScale();
+    void requestRedraw() { m_redrawRequested = true; }
+    [[nodiscard]] bool needsRedraw() const { return !m_idleValid || m_settleFrames > 0 || m_redrawRequested || m_anyItemActive || m_scale != m_scaleTarget; }
     [[nodiscard]] ImVec2 size() const { return m_size; }
     [[nodiscard]] float scale() const { return m_scale; }
+    // Scale of the sizes drawn by the content: the nested context is scaled afterwards, direct drawing isn't
+    [[nodiscard]] float drawScale() const { return m_config.direct ? m_scale : 1.f; }
     [[nodiscard]] const ImVec2& origin() const { return m_origin; }
     [[nodiscard]] bool hovered() const { return m_hovered; }
     [[nodiscard]] const ImVec2& scroll() const { return m_scroll; }
@@ -97,6 +201,18 @@ private:
 
     float m_scale = m_config.default_zoom, m_scaleTarget = m_config.default_zoom;
     ImVec2 m_scroll = {0.f, 0.f};
+
+    bool m_idle = false;
+    bool m_idleValid = false;
+    bool m_redrawRequested = false;
+    int m_settleFrames = 0;
+    ImVec2 m_idleOrigin, m_idleSize;
+    ImVector<ImDrawVert> m_idleVtx;
+    ImVector<ImDrawIdx> m_idleIdx;
+    ImVector<ImDrawCmd> m_idleCmd;
+    int m_captureVtx = 0, m_captureIdx = 0;
+
+    ImGuiStyle m_directStyle;
 };
 
 inline ContainedContext::~ContainedContext()
@@ -112,18 +228,41 @@ inline void ContainedContext::setFontDensity()
 #endif
 }
 
-inline void ContainedContext::begin()
+inline bool ContainedContext::begin()
 {
     ImGui::PushID(this);
     ImGui::PushStyleColor(ImGuiCol_ChildBg, m_config.color);
-    ImGui::BeginChild("view_port", m_config.size, 0, ImGuiWindowFlags_NoMove);
-    setFontDensity();
+    ImGuiWindowFlags flags = ImGuiWindowFlags_NoMove;
+    if (m_config.direct)
+        flags |= ImGuiWindowFlags_NoScrollbar | ImGuiWindowFlags_NoScrollWithMouse;
+    ImGui::BeginChild("view_port", m_config.size, 0, flags);
+    if (!m_config.direct)
+        setFontDensity();
     ImGui::PopStyleColor();
     m_pos = ImGui::GetWindowPos();
 
     m_size = ImGui::GetContentRegionAvail();
     m_origin = ImGui::GetCursorScreenPos();
     m_original_ctx = ImGui::GetCurrentContext();
+
+    // Idle fast path
+    bool moved = m_origin.x != m_idleOrigin.x || m_origin.y != m_idleOrigin.y || m_size.x != m_idleSize.x || m_size.y != m_idleSize.y;
+    if (m_original_ctx->InputEventsTrail.Size > 0 || m_redrawRequested || m_anyItemActive || m_scale != m_scaleTarget || moved)
+        m_settleFrames = m_config.idle_settle_frames;
+    m_redrawRequested = false;
+    m_idle = m_config.idle_skip && m_idleValid && m_settleFrames <= 0;
+    if (m_idle)
+    {
+        AppendDrawData(m_idleVtx, m_idleIdx, m_idleCmd, ImVec2(0.f, 0.f), 1.f);
+        return false;
+    }
+    if (m_settleFrames > 0)
+        m_settleFrames--;
+    m_captureVtx = ImGui::GetWindowDrawList()->VtxBuffer.size();
+    m_captureIdx = ImGui::GetWindowDrawList()->IdxBuffer.size();
+
+    if (m_config.direct)
+        return true;
     const ImGuiStyle& orig_style = ImGui::GetStyle();
     if (!m_ctx) m_ctx = ImGui::CreateContext(ImGui::GetIO().Fonts);
     ImGui::SetCurrentContext(m_ctx);
@@ -146,7 +285,7 @@ inline void ContainedContext::begin()
     ImGui::NewFrame();
 
     if (!m_config.extra_window_wrapper)
-        return;
+        return true;
     ImGui::SetNextWindowPos(ImVec2(0, 0), ImGuiCond_Appearing);
     ImGui::SetNextWindowSize(ImGui::GetMainViewport()->WorkSize);
     ImGui::PushStyleVar(ImGuiStyleVar_WindowPadding, ImVec2(0, 0));
@@ -154,29 +293,87 @@ inline void ContainedContext::begin()
                                                 | ImGuiWindowFlags_NoScrollbar | ImGuiWindowFlags_NoScrollWithMouse);
     setFontDensity();
     ImGui::PopStyleVar();
+    return true;
 }
 
 inline void ContainedContext::end()
 {
-    m_anyWindowHovered = ImGui::IsWindowHovered(ImGuiHoveredFlags_AnyWindow);
-    if (m_config.extra_window_wrapper && ImGui::IsWindowHovered())
+    if (m_idle)
+    {
+        m_hovered = ImGui::IsWindowHovered(ImGuiHoveredFlags_ChildWindows) && !m_anyWindowHovered;
+        m_original_ctx = nullptr;
+        ImGui::EndChild();
+        ImGui::PopID();
+        return;
+    }
+
+    if (m_config.direct)
+    {
         m_anyWindowHovered = false;
+        m_anyItemActive = ImGui::IsAnyItemActive() && ImGui::IsWindowFocused(ImGuiFocusedFlags_ChildWindows);
+        m_original_ctx = nullptr;
+    }
+    else
+    {
+        m_anyWindowHovered = ImGui::IsWindowHovered(ImGuiHoveredFlags_AnyWindow);
+        if (m_config.extra_window_wrapper && ImGui::IsWindowHovered())
+            m_anyWindowHovered = false;
 
-    m_anyItemActive = ImGui::IsAnyItemActive();
+        m_anyItemActive = ImGui::IsAnyItemActive();
 
-    if (m_config.extra_window_wrapper)
-        ImGui::End();
+        if (m_config.extra_window_wrapper)
+            ImGui::End();
 
-    ImGui::Render();
+        ImGui::Render();
 
-    ImDrawData* draw_data = ImGui::GetDrawData();
+        ImDrawData* draw_data = ImGui::GetDrawData();
 
-    m_original_ctx->PlatformImeData = m_ctx->PlatformImeData;
-    ImGui::SetCurrentContext(m_original_ctx);
-    m_original_ctx = nullptr;
+        m_original_ctx->PlatformImeData = m_ctx->PlatformImeData;
+        ImGui::SetCurrentContext(m_original_ctx);
+        m_original_ctx = nullptr;
+
+        for (int i = 0; i < draw_data->CmdListsCount; ++i)
+            AppendDrawData(draw_data->CmdLists[i], m_origin, m_scale);
+    }
 
-    for (int i = 0; i < draw_data->CmdListsCount; ++i)
-        AppendDrawData(draw_data->CmdLists[i], m_origin, m_scale);
+    // Keep the output, relative to its first vertex and index, to replay it while idle
+    // Commands are clipped to the indices of this frame: in direct mode the first ones may be shared with the parent
+    if (m_config.idle_skip)
+    {
+        ImDrawList* dl = ImGui::GetWindowDrawList();
+        const int vtx_start = m_captureVtx;
+        const int idx_start = m_captureIdx;
+        const int idx_end = dl->IdxBuffer.size();
+        m_idleVtx.resize(dl->VtxBuffer.size() - vtx_start);
+        if (!m_idleVtx.empty())
+            memcpy(m_idleVtx.Data, dl->VtxBuffer.Data + vtx_start, m_idleVtx.size_in_bytes());
+        m_idleIdx.resize(idx_end - idx_start);
+        m_idleCmd.resize(0);
+        for (const ImDrawCmd& src : dl->CmdBuffer)
+        {
+            const int first = ImMax((int)src.IdxOffset, idx_start);
+            const int last = ImMin((int)(src.IdxOffset + src.ElemCount), idx_end);
+            if (last <= first || src.UserCallback != nullptr)
+                continue;
+            ImDrawCmd cmd = src;
+            cmd.IdxOffset = first - idx_start;
+            cmd.ElemCount = last - first;
+            // Indices are relative to VtxOffset, rebased when it points before the captured vertices
+            unsigned int base = 0;
+            if ((int)cmd.VtxOffset >= vtx_start)
+                cmd.VtxOffset -= vtx_start;
+            else
+            {
+                base = cmd.VtxOffset - vtx_start;
+                cmd.VtxOffset = 0;
+            }
+            RebaseIndices(dl->IdxBuffer.Data + first, m_idleIdx.Data + cmd.IdxOffset, cmd.ElemCount, base);
+            m_idleCmd.push_back(cmd);
+        }
+        m_idleOrigin = m_origin;
+        m_idleSize = m_size;
+        m_idleValid = true;
+    }
 
     m_hovered = ImGui::IsWindowHovered(ImGuiHoveredFlags_ChildWindows) && !m_anyWindowHovered;
 
@@ -215,7 +412,25 @@ inline void ContainedContext::end()
     {
         m_scroll += ImGui::GetIO().MouseDelta / m_scale;
     }
-    this->m_ctx->IO.MousePos = (ImGui::GetMousePos() - m_origin) / m_scale;
+    if (m_ctx)
+        m_ctx->IO.MousePos = (ImGui::GetMousePos() - m_origin) / m_scale;
     ImGui::EndChild();
     ImGui::PopID();
 }
+
+inline void ContainedContext::pushScale()
+{
+    if (!m_config.direct)
+        return;
+    m_directStyle = ImGui::GetStyle();
+    ImGui::GetStyle().ScaleAllSizes(m_scale);
+    ImGui::SetWindowFontScale(m_scale);
+}
+
+inline void ContainedContext::popScale()
+{
+    if (!m_config.direct)
+        return;
+    ImGui::GetStyle() = m_directStyle;
+    ImGui::SetWindowFontScale(1.f);
+}
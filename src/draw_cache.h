@@ -0,0 +1,87 @@
+#pragma once
+
+#include <vector>
+#include <imgui.h>
+#include <imgui_internal.h>
+
+/**
+ * @brief Retained copy of primitives added to a draw list
+ * @details Keeps the vertices and indices generated between begin() and end(), relative to an origin,
+ *          and replays them at any origin without tessellating the shapes again.
+ *          Only primitives that went into a single draw command (same clip rect, texture and vertex offset) are kept.
+ */
+class DrawListCache
+{
+public:
+    /**
+     * @brief Start recording the primitives added to "dl"
+     */
+    void begin(ImDrawList* dl);
+
+    /**
+     * @brief Stop recording and keep the primitives added since begin()
+     * @param dl Same draw list as begin()
+     * @param origin Origin the primitives are stored relative to
+     * @return [TRUE] if the primitives could be kept
+     */
+    bool end(ImDrawList* dl, const ImVec2& origin);
+
+    /**
+     * @brief Add the kept primitives to "dl", translated to "origin"
+     */
+    void replay(ImDrawList* dl, const ImVec2& origin) const;
+
+    void invalidate() { m_valid = false; }
+    [[nodiscard]] bool valid() const { return m_valid; }
+private:
+    std::vector<ImDrawVert> m_vtx;
+    std::vector<ImDrawIdx> m_idx;
+    int m_vtxStart = 0, m_idxStart = 0, m_cmdCount = 0;
+    unsigned int m_vtxCurrent = 0;
+    bool m_valid = false;
+};
+
+inline void DrawListCache::begin(ImDrawList* dl)
+{
+    m_vtxStart = dl->VtxBuffer.Size;
+    m_idxStart = dl->IdxBuffer.Size;
+    m_cmdCount = dl->CmdBuffer.Size;
+    m_vtxCurrent = dl->_VtxCurrentIdx;
+}
+
+inline bool DrawListCache::end(ImDrawList* dl, const ImVec2& origin)
+{
+    int vtxCount = dl->VtxBuffer.Size - m_vtxStart;
+    int idxCount = dl->IdxBuffer.Size - m_idxStart;
+    // A new command (e.g. the vertex offset moved past 64k vertices) would split the indices
+    m_valid = dl->CmdBuffer.Size == m_cmdCount && dl->_VtxCurrentIdx - m_vtxCurrent == (unsigned int)vtxCount;
+    if (!m_valid)
+        return false;
+
+    m_vtx.assign(dl->VtxBuffer.Data + m_vtxStart, dl->VtxBuffer.Data + m_vtxStart + vtxCount);
+    for (ImDrawVert& v : m_vtx)
+        v.pos = v.pos - origin;
+    m_idx.resize(idxCount);
+    for (int i = 0; i < idxCount; i++)
+        m_idx[i] = (ImDrawIdx)(dl->IdxBuffer.Data[m_idxStart + i] - m_vtxCurrent);
+    return true;
+}
+
+inline void DrawListCache::replay(ImDrawList* dl, const ImVec2& origin) const
+{
+    if (m_idx.empty())
+        return;
+    dl->PrimReserve((int)m_idx.size(), (int)m_vtx.size());
+    // Read after reserving, which may start a new vertex offset
+    unsigned int base = dl->_VtxCurrentIdx;
+    for (size_t i = 0; i < m_vtx.size(); i++)
+    {
+        dl->_VtxWritePtr[i] = m_vtx[i];
+        dl->_VtxWritePtr[i].pos = m_vtx[i].pos + origin;
+    }
+    for (size_t i = 0; i < m_idx.size(); i++)
+        dl->_IdxWritePtr[i] = (ImDrawIdx)(m_idx[i] + base);
+    dl->_VtxWritePtr += m_vtx.size();
+    dl->_IdxWritePtr += m_idx.size();
+    dl->_VtxCurrentIdx += (unsigned int)m_vtx.size();
+}
@@ -0,0 +1,85 @@
+#pragma once
+
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/**
+ * @brief Fixed number of threads running independent jobs in submission order
+ * @details Threads are started as jobs are submitted, up to the limit given on creation.
+ *          Jobs still queued when the queue is destroyed are run before the threads are joined.
+ */
+class JobQueue
+{
+public:
+    explicit JobQueue(unsigned threads) :m_maxThreads(threads ? threads : 1) {}
+    ~JobQueue();
+    JobQueue(const JobQueue&) = delete;
+    JobQueue& operator=(const JobQueue&) = delete;
+
+    /**
+     * @brief Queue a job
+     * @param job Function run on one of the threads, must not throw
+     */
+    void push(std::function<void()> job);
+
+    [[nodiscard]] unsigned size() const { return m_maxThreads; }
+private:
+    void workerLoop();
+
+    unsigned m_maxThreads;
+    std::vector<std::thread> m_threads;
+    std::mutex m_mutex;
+    std::condition_variable m_wake;
+    std::deque<std::function<void()>> m_jobs;
+    unsigned m_idle = 0;
+    bool m_stop = false;
+};
+
+inline JobQueue::~JobQueue()
+{
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_stop = true;
+    }
+    m_wake.notify_all();
+    for (auto& t : m_threads)
+        t.join();
+}
+
+inline void JobQueue::push(std::function<void()> job)
+{
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_jobs.push_back(std::move(job));
+        // Idle threads may already be woken for the previous jobs
+        if (m_jobs.size() > m_idle && m_threads.size() < m_maxThreads)
+        {
+            m_threads.emplace_back(&JobQueue::workerLoop, this);
+            return;
+        }
+    }
+    m_wake.notify_one();
+}
+
+inline void JobQueue::workerLoop()
+{
+    std::unique_lock<std::mutex> lock(m_mutex);
+    while (true)
+    {
+        m_idle++;
+        m_wake.wait(lock, [&] { return m_stop || !m_jobs.empty(); });
+        m_idle--;
+        if (m_jobs.empty())
+            return;
+
+        std::function<void()> job = std::move(m_jobs.front());
+        m_jobs.pop_front();
+        lock.unlock();
+        job();
+        lock.lock();
+    }
+}
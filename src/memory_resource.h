@@ -0,0 +1,298 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <vector>
+
+namespace ImFlow
+{
+    // -----------------------------------------------------------------------------------------------------------------
+    // MEMORY RESOURCES
+
+    /// @brief Kind of object allocated by a handler
+    enum MemoryKind
+    {
+        MemoryKind_Node,
+        MemoryKind_Pin,
+        MemoryKind_Link,
+        MemoryKind_COUNT
+    };
+
+    /// @brief Allocation statistics of one kind of object
+    struct MemoryCounters
+    {
+        /// @brief Number of allocations since the creation of the resource
+        size_t allocations = 0;
+        /// @brief Number of deallocations since the creation of the resource
+        size_t deallocations = 0;
+        /// @brief Bytes currently allocated
+        size_t bytes = 0;
+    };
+
+    /// @brief Memory used by the objects of an editor, in bytes
+    struct MemoryReport
+    {
+        /// @brief Nodes, allocated from the editor's resource
+        size_t nodes = 0;
+        /// @brief Pins, allocated from the editor's resource
+        size_t pins = 0;
+        /// @brief Links, allocated from the editor's resource
+        size_t links = 0;
+        /// @brief Distinct styles used by the nodes and pins
+        size_t styles = 0;
+        /// @brief Number of distinct styles
+        size_t styleCount = 0;
+    };
+
+    /**
+     * @brief Source of the memory of nodes, pins and links
+     * @details Counts allocations per kind of object. Derived classes provide the memory itself.
+     *          Calls are serialized, objects may be released from any thread.
+     */
+    class MemoryResource
+    {
+    public:
+        virtual ~MemoryResource() = default;
+
+        void* allocate(size_t size, size_t align, MemoryKind kind);
+        void deallocate(void* p, size_t size, size_t align, MemoryKind kind);
+
+        /**
+         * @brief <BR>Give the memory back to the system in bulk
+         * @details Only done while nothing allocated from the resource is alive.
+         */
+        void release();
+
+        /**
+         * @brief <BR>Get the statistics of one kind of object
+         */
+        [[nodiscard]] MemoryCounters counters(MemoryKind kind) const;
+
+        /**
+         * @brief <BR>Get the number of objects currently alive
+         */
+        [[nodiscard]] size_t live() const;
+
+        /**
+         * @brief <BR>Get the resource used when no handler is known yet (e.g. pins added in a node's constructor)
+         * @details Set by ImNodeFlow::addNode() while the node is built, std::allocator like otherwise.
+         */
+        static std::shared_ptr<MemoryResource> current();
+    protected:
+        virtual void* doAllocate(size_t size, size_t align) = 0;
+        virtual void doDeallocate(void* p, size_t size, size_t align) = 0;
+        virtual void doRelease() {}
+    private:
+        friend class ScopedMemoryResource;
+        static std::shared_ptr<MemoryResource>& threadCurrent() { thread_local std::shared_ptr<MemoryResource> r; return r; }
+
+        mutable std::mutex m_mutex;
+        MemoryCounters m_counters[MemoryKind_COUNT];
+    };
+
+    /**
+     * @brief Counting resource forwarding to the global operator new
+     */
+    class NewDeleteResource : public MemoryResource
+    {
+    protected:
+        void* doAllocate(size_t size, size_t align) override { return ::operator new(size, std::align_val_t(align)); }
+        void doDeallocate(void* p, size_t size, size_t align) override { ::operator delete(p, size, std::align_val_t(align)); }
+    };
+
+    /**
+     * @brief Resource carving small objects out of large chunks
+     * @details Blocks are grouped in size classes with a free list each, so freed pins and links are reused
+     *          by the next ones. Large or over-aligned objects go to the global operator new.
+     */
+    class PoolResource : public MemoryResource
+    {
+    public:
+        /**
+         * @brief <BR>Create a pool
+         * @param chunkSize Size of the chunks requested to the system in bytes, at least the largest pooled block (1 KiB)
+         */
+        explicit PoolResource(size_t chunkSize = 64 * 1024) :m_chunkSize(std::max(chunkSize, MaxPooled)) {}
+        ~PoolResource() override { doRelease(); }
+    protected:
+        void* doAllocate(size_t size, size_t align) override;
+        void doDeallocate(void* p, size_t size, size_t align) override;
+        void doRelease() override;
+    private:
+        static constexpr size_t Granularity = 16;
+        static constexpr size_t MaxPooled = 1024;
+        struct FreeBlock { FreeBlock* next; };
+
+        static bool pooled(size_t size, size_t align) { return size <= MaxPooled && align <= Granularity; }
+        static size_t sizeClass(size_t size) { return (size + Granularity - 1) / Granularity - 1; }
+
+        size_t m_chunkSize;
+        std::vector<void*> m_chunks;
+        char* m_cursor = nullptr;
+        size_t m_remaining = 0;
+        FreeBlock* m_free[MaxPooled / Granularity] = {};
+    };
+
+    /**
+     * @brief Standard allocator drawing from a MemoryResource
+     * @details Keeps the resource alive, so objects allocated with std::allocate_shared can outlive their handler.
+     */
+    template<typename T>
+    class ResourceAllocator
+    {
+    public:
+        using value_type = T;
+
+        ResourceAllocator(std::shared_ptr<MemoryResource> resource, MemoryKind kind) :m_resource(std::move(resource)), m_kind(kind) {}
+        template<typename U>
+        ResourceAllocator(const ResourceAllocator<U>& other) :m_resource(other.resource()), m_kind(other.kind()) {}
+
+        T* allocate(size_t n) { return static_cast<T*>(m_resource->allocate(n * sizeof(T), alignof(T), m_kind)); }
+        void deallocate(T* p, size_t n) { m_resource->deallocate(p, n * sizeof(T), alignof(T), m_kind); }
+
+        [[nodiscard]] const std::shared_ptr<MemoryResource>& resource() const { return m_resource; }
+        [[nodiscard]] MemoryKind kind() const { return m_kind; }
+
+        template<typename U>
+        bool operator==(const ResourceAllocator<U>& other) const { return m_resource == other.resource(); }
+        template<typename U>
+        bool operator!=(const ResourceAllocator<U>& other) const { return m_resource != other.resource(); }
+    private:
+        std::shared_ptr<MemoryResource> m_resource;
+        MemoryKind m_kind;
+    };
+
+    /**
+     * @brief Make a resource the current one of the thread for a scope
+     */
+    class ScopedMemoryResource
+    {
+    public:
+        explicit ScopedMemoryResource(std::shared_ptr<MemoryResource> resource)
+            :m_previous(std::move(MemoryResource::threadCurrent())) { MemoryResource::threadCurrent() = std::move(resource); }
+        ~ScopedMemoryResource() { MemoryResource::threadCurrent() = std::move(m_previous); }
+        ScopedMemoryResource(const ScopedMemoryResource&) = delete;
+        ScopedMemoryResource& operator=(const ScopedMemoryResource&) = delete;
+    private:
+        std::shared_ptr<MemoryResource> m_previous;
+    };
+
+    /**
+     * @brief Create an object in a resource
+     * @tparam T Type of the object
+     * @param resource Resource to allocate from
+     * @param kind Kind of object, for the counters
+     * @param args Arguments of the constructor
+     */
+    template<typename T, typename... Args>
+    std::shared_ptr<T> allocateShared(const std::shared_ptr<MemoryResource>& resource, MemoryKind kind, Args&&... args)
+    {
+        return std::allocate_shared<T>(ResourceAllocator<T>(resource, kind), std::forward<Args>(args)...);
+    }
+
+    // -----------------------------------------------------------------------------------------------------------------
+    // IMPLEMENTATION
+
+    inline void* MemoryResource::allocate(size_t size, size_t align, MemoryKind kind)
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        void* p = doAllocate(size, align);
+        m_counters[kind].allocations++;
+        m_counters[kind].bytes += size;
+        return p;
+    }
+
+    inline void MemoryResource::deallocate(void* p, size_t size, size_t align, MemoryKind kind)
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        doDeallocate(p, size, align);
+        m_counters[kind].deallocations++;
+        m_counters[kind].bytes -= size;
+    }
+
+    inline void MemoryResource::release()
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        for (const MemoryCounters& c : m_counters)
+            if (c.allocations != c.deallocations)
+                return;
+        doRelease();
+    }
+
+    inline MemoryCounters MemoryResource::counters(MemoryKind kind) const
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        return m_counters[kind];
+    }
+
+    inline size_t MemoryResource::live() const
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        size_t n = 0;
+        for (const MemoryCounters& c : m_counters)
+            n += c.allocations - c.deallocations;
+        return n;
+    }
+
+    inline std::shared_ptr<MemoryResource> MemoryResource::current()
+    {
+        static std::shared_ptr<MemoryResource> fallback = std::make_shared<NewDeleteResource>();
+        const std::shared_ptr<MemoryResource>& r = threadCurrent();
+        return r ? r : fallback;
+    }
+
+    inline void* PoolResource::doAllocate(size_t size, size_t align)
+    {
+        if (!pooled(size, align))
+            return ::operator new(size, std::align_val_t(align));
+
+        size_t c = sizeClass(size);
+        if (m_free[c])
+        {
+            FreeBlock* b = m_free[c];
+            m_free[c] = b->next;
+            return b;
+        }
+
+        size_t blockSize = (c + 1) * Granularity;
+        if (m_remaining < blockSize)
+        {
+            // The tail of the previous chunk is left unused
+            m_cursor = static_cast<char*>(::operator new(m_chunkSize, std::align_val_t(Granularity)));
+            m_chunks.push_back(m_cursor);
+            m_remaining = m_chunkSize;
+        }
+        void* p = m_cursor;
+        m_cursor += blockSize;
+        m_remaining -= blockSize;
+        return p;
+    }
+
+    inline void PoolResource::doDeallocate(void* p, size_t size, size_t align)
+    {
+        if (!pooled(size, align))
+        {
+            ::operator delete(p, size, std::align_val_t(align));
+            return;
+        }
+
+        size_t c = sizeClass(size);
+        auto* b = static_cast<FreeBlock*>(p);
+        b->next = m_free[c];
+        m_free[c] = b;
+    }
+
+    inline void PoolResource::doRelease()
+    {
+        for (void* chunk : m_chunks)
+            ::operator delete(chunk, m_chunkSize, std::align_val_t(Granularity));
+        m_chunks.clear();
+        m_cursor = nullptr;
+        m_remaining = 0;
+        for (FreeBlock*& f : m_free)
+            f = nullptr;
+    }
+}
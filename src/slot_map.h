@@ -0,0 +1,147 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+/**
+ * @brief Dense storage addressed by generational handles
+ * @details Values are stored contiguously and iterated in storage order. A handle holds a slot index and
+ *          the generation of the slot, so handles of removed values never match a later value.
+ *          Insertion, lookup and removal are O(1), removal moves the last value in the hole.
+ * @tparam T Type of the values
+ */
+template<typename T>
+class SlotMap
+{
+public:
+    /// @brief Handle of a value, never 0
+    using Handle = uint64_t;
+
+    /**
+     * @brief Insert a value
+     * @return Handle of the new value
+     */
+    Handle insert(T value);
+
+    /**
+     * @brief Remove a value
+     * @details The value is destroyed after the map is updated, so its destructor can safely use the map.
+     * @return [TRUE] if the handle was valid
+     */
+    bool erase(Handle handle);
+
+    /**
+     * @brief Find a value
+     * @return Pointer to the value, nullptr if the handle isn't valid anymore
+     */
+    T* get(Handle handle);
+    const T* get(Handle handle) const;
+
+    [[nodiscard]] bool contains(Handle handle) const { return get(handle) != nullptr; }
+
+    /**
+     * @brief Get the handle of the value at a position of the storage
+     */
+    [[nodiscard]] Handle handleAt(size_t i) const { return m_handles[i]; }
+
+    T& operator[](size_t i) { return m_values[i]; }
+    const T& operator[](size_t i) const { return m_values[i]; }
+    [[nodiscard]] size_t size() const { return m_values.size(); }
+    [[nodiscard]] bool empty() const { return m_values.empty(); }
+    void reserve(size_t n) { m_values.reserve(n); m_handles.reserve(n); m_slots.reserve(n); }
+    void clear();
+
+    typename std::vector<T>::iterator begin() { return m_values.begin(); }
+    typename std::vector<T>::iterator end() { return m_values.end(); }
+    typename std::vector<T>::const_iterator begin() const { return m_values.begin(); }
+    typename std::vector<T>::const_iterator end() const { return m_values.end(); }
+private:
+    struct Slot
+    {
+        uint32_t dense;      // Position of the value, or next free slot
+        uint32_t generation; // Odd while occupied, even while free
+    };
+
+    static constexpr uint32_t None = UINT32_MAX;
+    static uint32_t slotOf(Handle h) { return (uint32_t)h; }
+    static uint32_t generationOf(Handle h) { return (uint32_t)(h >> 32); }
+    static Handle makeHandle(uint32_t slot, uint32_t generation) { return ((Handle)generation << 32) | slot; }
+
+    std::vector<T> m_values;
+    std::vector<Handle> m_handles;
+    std::vector<Slot> m_slots;
+    uint32_t m_freeHead = None;
+};
+
+template<typename T>
+inline typename SlotMap<T>::Handle SlotMap<T>::insert(T value)
+{
+    uint32_t slot = m_freeHead;
+    if (slot != None)
+        m_freeHead = m_slots[slot].dense;
+    else
+    {
+        slot = (uint32_t)m_slots.size();
+        m_slots.push_back({None, 0});
+    }
+
+    m_slots[slot].dense = (uint32_t)m_values.size();
+    m_slots[slot].generation++;
+    Handle h = makeHandle(slot, m_slots[slot].generation);
+    m_values.push_back(std::move(value));
+    m_handles.push_back(h);
+    return h;
+}
+
+template<typename T>
+inline bool SlotMap<T>::erase(Handle handle)
+{
+    if (!contains(handle))
+        return false;
+
+    Slot& s = m_slots[slotOf(handle)];
+    uint32_t dense = s.dense;
+    T removed = std::move(m_values[dense]);
+    if (dense + 1 != m_values.size())
+    {
+        m_values[dense] = std::move(m_values.back());
+        m_handles[dense] = m_handles.back();
+        m_slots[slotOf(m_handles[dense])].dense = dense;
+    }
+    m_values.pop_back();
+    m_handles.pop_back();
+
+    // Even: handles of the freed slot, whatever their generation, don't resolve anymore.
+    // Wrapping back to 0 is fine as occupied generations are odd, so handles are never 0.
+    s.generation++;
+    s.dense = m_freeHead;
+    m_freeHead = slotOf(handle);
+    return true;
+}
+
+template<typename T>
+inline T* SlotMap<T>::get(Handle handle)
+{
+    uint32_t slot = slotOf(handle);
+    if (slot >= m_slots.size())
+        return nullptr;
+    uint32_t generation = m_slots[slot].generation;
+    if ((generation & 1) == 0 || generation != generationOf(handle))
+        return nullptr;
+    return &m_values[m_slots[slot].dense];
+}
+
+template<typename T>
+inline const T* SlotMap<T>::get(Handle handle) const
+{
+    return const_cast<SlotMap<T>*>(this)->get(handle);
+}
+
+template<typename T>
+inline void SlotMap<T>::clear()
+{
+    while (!m_handles.empty())
+        erase(m_handles.back());
+}
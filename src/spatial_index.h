@@ -0,0 +1,160 @@
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+#include <imgui.h>
+#include <imgui_internal.h>
+
+/**
+ * @brief Uniform grid hash of rectangles
+ * @details Each item is stored in every cell its rectangle touches. Moving an item only touches the index
+ *          when it changes cells, so it can be updated every frame.
+ * @tparam T Key of the items (e.g. a pointer)
+ */
+template<typename T>
+class SpatialIndex
+{
+public:
+    explicit SpatialIndex(float cellSize = 256.f) :m_cellSize(cellSize) {}
+
+    /**
+     * @brief Insert an item or move it to a new rectangle
+     * @param item Key of the item
+     * @param rect Rectangle covered by the item
+     */
+    void update(T item, const ImRect& rect);
+
+    /**
+     * @brief Remove an item, does nothing if it isn't indexed
+     * @param item Key of the item
+     */
+    void remove(T item);
+
+    /**
+     * @brief Call "f" for each item whose rectangle contains the point
+     */
+    template<typename F>
+    void queryPoint(const ImVec2& p, F&& f) const;
+
+    /**
+     * @brief Call "f" once for each item whose rectangle overlaps "rect"
+     */
+    template<typename F>
+    void queryRect(const ImRect& rect, F&& f) const;
+
+    void clear() { m_cells.clear(); m_items.clear(); }
+    [[nodiscard]] size_t size() const { return m_items.size(); }
+private:
+    struct Entry
+    {
+        ImRect rect;
+        int x0, y0, x1, y1;
+    };
+
+    [[nodiscard]] int cell(float v) const { return (int)std::floor(v / m_cellSize); }
+    static uint64_t key(int x, int y) { return ((uint64_t)(uint32_t)x << 32) | (uint32_t)y; }
+    void link(T item, const Entry& e);
+    void unlink(T item, const Entry& e);
+
+    float m_cellSize;
+    std::unordered_map<uint64_t, std::vector<T>> m_cells;
+    std::unordered_map<T, Entry> m_items;
+};
+
+template<typename T>
+inline void SpatialIndex<T>::update(T item, const ImRect& rect)
+{
+    Entry e{rect, cell(rect.Min.x), cell(rect.Min.y), cell(rect.Max.x), cell(rect.Max.y)};
+    auto it = m_items.find(item);
+    if (it == m_items.end())
+    {
+        link(item, e);
+        m_items.emplace(item, e);
+        return;
+    }
+
+    Entry& old = it->second;
+    if (old.x0 != e.x0 || old.y0 != e.y0 || old.x1 != e.x1 || old.y1 != e.y1)
+    {
+        unlink(item, old);
+        link(item, e);
+    }
+    old = e;
+}
+
+template<typename T>
+inline void SpatialIndex<T>::remove(T item)
+{
+    auto it = m_items.find(item);
+    if (it == m_items.end())
+        return;
+    unlink(item, it->second);
+    m_items.erase(it);
+}
+
+template<typename T>
+template<typename F>
+inline void SpatialIndex<T>::queryPoint(const ImVec2& p, F&& f) const
+{
+    auto c = m_cells.find(key(cell(p.x), cell(p.y)));
+    if (c == m_cells.end())
+        return;
+    for (T item : c->second)
+        if (m_items.at(item).rect.Contains(p))
+            f(item);
+}
+
+template<typename T>
+template<typename F>
+inline void SpatialIndex<T>::queryRect(const ImRect& rect, F&& f) const
+{
+    int x0 = cell(rect.Min.x), y0 = cell(rect.Min.y), x1 = cell(rect.Max.x), y1 = cell(rect.Max.y);
+    for (int x = x0; x <= x1; x++)
+        for (int y = y0; y <= y1; y++)
+        {
+            auto c = m_cells.find(key(x, y));
+            if (c == m_cells.end())
+                continue;
+            for (T item : c->second)
+            {
+                const Entry& e = m_items.at(item);
+                // Only reported by the first cell shared with the query
+                if (x != std::max(x0, e.x0) || y != std::max(y0, e.y0))
+                    continue;
+                if (e.rect.Overlaps(rect))
+                    f(item);
+            }
+        }
+}
+
+template<typename T>
+inline void SpatialIndex<T>::link(T item, const Entry& e)
+{
+    for (int x = e.x0; x <= e.x1; x++)
+        for (int y = e.y0; y <= e.y1; y++)
+            m_cells[key(x, y)].push_back(item);
+}
+
+template<typename T>
+inline void SpatialIndex<T>::unlink(T item, const Entry& e)
+{
+    for (int x = e.x0; x <= e.x1; x++)
+        for (int y = e.y0; y <= e.y1; y++)
+        {
+            auto c = m_cells.find(key(x, y));
+            if (c == m_cells.end())
+                continue;
+            auto& v = c->second;
+            auto it = std::find(v.begin(), v.end(), item);
+            if (it != v.end())
+            {
+                *it = v.back();
+                v.pop_back();
+            }
+            if (v.empty())
+                m_cells.erase(c);
+        }
+}
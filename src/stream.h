@@ -0,0 +1,222 @@
+#pragma once
+
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <new>
+#include <type_traits>
+
+#if defined(__AVX__)
+#include <immintrin.h>
+#elif defined(__SSE__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 1)
+#include <xmmintrin.h>
+#define IMNODEFLOW_STREAM_SSE
+#endif
+
+namespace ImFlow
+{
+    template<typename T> class InPin;
+    template<typename T> class OutPin;
+
+    // -----------------------------------------------------------------------------------------------------------------
+    // STREAM
+
+    /**
+     * @brief Read-only array shared between pins
+     * @details The buffer is aligned and reference counted: copying a stream (e.g. passing it through a link) never copies the data.
+     *          A slice is a stream viewing part of another one's buffer, and keeping that buffer alive.
+     * @tparam T Type of the elements
+     */
+    template<typename T>
+    class Stream
+    {
+        static_assert(std::is_trivially_copyable<T>::value, "Stream elements must be trivially copyable!");
+    public:
+        /// @brief Alignment of the buffer in bytes, enough for AVX loads
+        static constexpr size_t Alignment = 32;
+
+        /**
+         * @brief <BR>Construct an empty stream
+         */
+        Stream() = default;
+
+        /**
+         * @brief <BR>Allocate a new stream
+         * @details The elements are left uninitialized, use mutableData() to fill them before sharing the stream.
+         * @param size Number of elements
+         */
+        explicit Stream(size_t size)
+            :m_data(static_cast<T*>(::operator new(size * sizeof(T), std::align_val_t(Alignment))),
+                    [](T* p) { ::operator delete(p, std::align_val_t(Alignment)); }), m_size(size) {}
+
+        /**
+         * @brief <BR>Get writable access to the buffer
+         * @details Only allowed while the stream is not shared yet.
+         * @return Pointer to the first element
+         */
+        T* mutableData() { assert(m_data.use_count() <= 1 && "Stream is shared, it can't be modified!"); return m_data.get(); }
+
+        /**
+         * @brief <BR>Get a view of part of the stream, sharing its buffer
+         * @details Only the whole stream is aligned, slices may start anywhere.
+         * @param offset Index of the first element, clamped to the size
+         * @param count Maximum number of elements
+         * @return Stream of the elements from "offset" to "offset + count" or the end
+         */
+        [[nodiscard]] Stream slice(size_t offset, size_t count = SIZE_MAX) const
+        {
+            offset = offset < m_size ? offset : m_size;
+            count = count < m_size - offset ? count : m_size - offset;
+            return Stream(std::shared_ptr<T>(m_data, m_data.get() + offset), count);
+        }
+
+        [[nodiscard]] const T* data() const { return m_data.get(); }
+        [[nodiscard]] size_t size() const { return m_size; }
+        [[nodiscard]] bool empty() const { return m_size == 0; }
+        [[nodiscard]] const T* begin() const { return m_data.get(); }
+        [[nodiscard]] const T* end() const { return m_data.get() + m_size; }
+        const T& operator[](size_t i) const { return m_data.get()[i]; }
+    private:
+        Stream(std::shared_ptr<T> data, size_t size) :m_data(std::move(data)), m_size(size) {}
+
+        std::shared_ptr<T> m_data;
+        size_t m_size = 0;
+    };
+
+    /// @brief Input pin receiving a stream
+    template<typename T> using InStream = InPin<Stream<T>>;
+    /// @brief Output pin producing a stream
+    template<typename T> using OutStream = OutPin<Stream<T>>;
+
+    // -----------------------------------------------------------------------------------------------------------------
+    // STREAM KERNELS
+
+    /**
+     * @brief Vectorized arithmetic on float streams
+     * @details Uses AVX or SSE when enabled at compile time, with a scalar fallback.
+     *          Binary operations output as many elements as the shortest input.
+     */
+    namespace StreamKernels
+    {
+        inline void add(const float* a, const float* b, float* out, size_t n)
+        {
+            size_t i = 0;
+#if defined(__AVX__)
+            for (; i + 8 <= n; i += 8)
+                _mm256_storeu_ps(out + i, _mm256_add_ps(_mm256_loadu_ps(a + i), _mm256_loadu_ps(b + i)));
+#elif defined(IMNODEFLOW_STREAM_SSE)
+            for (; i + 4 <= n; i += 4)
+                _mm_storeu_ps(out + i, _mm_add_ps(_mm_loadu_ps(a + i), _mm_loadu_ps(b + i)));
+#endif
+            for (; i < n; i++)
+                out[i] = a[i] + b[i];
+        }
+
+        inline void sub(const float* a, const float* b, float* out, size_t n)
+        {
+            size_t i = 0;
+#if defined(__AVX__)
+            for (; i + 8 <= n; i += 8)
+                _mm256_storeu_ps(out + i, _mm256_sub_ps(_mm256_loadu_ps(a + i), _mm256_loadu_ps(b + i)));
+#elif defined(IMNODEFLOW_STREAM_SSE)
+            for (; i + 4 <= n; i += 4)
+                _mm_storeu_ps(out + i, _mm_sub_ps(_mm_loadu_ps(a + i), _mm_loadu_ps(b + i)));
+#endif
+            for (; i < n; i++)
+                out[i] = a[i] - b[i];
+        }
+
+        inline void mul(const float* a, const float* b, float* out, size_t n)
+        {
+            size_t i = 0;
+#if defined(__AVX__)
+            for (; i + 8 <= n; i += 8)
+                _mm256_storeu_ps(out + i, _mm256_mul_ps(_mm256_loadu_ps(a + i), _mm256_loadu_ps(b + i)));
+#elif defined(IMNODEFLOW_STREAM_SSE)
+            for (; i + 4 <= n; i += 4)
+                _mm_storeu_ps(out + i, _mm_mul_ps(_mm_loadu_ps(a + i), _mm_loadu_ps(b + i)));
+#endif
+            for (; i < n; i++)
+                out[i] = a[i] * b[i];
+        }
+
+        /// @brief out = a * k + b
+        inline void scaleAdd(const float* a, float k, float b, float* out, size_t n)
+        {
+            size_t i = 0;
+#if defined(__AVX__)
+            __m256 vk = _mm256_set1_ps(k), vb = _mm256_set1_ps(b);
+            for (; i + 8 <= n; i += 8)
+                _mm256_storeu_ps(out + i, _mm256_add_ps(_mm256_mul_ps(_mm256_loadu_ps(a + i), vk), vb));
+#elif defined(IMNODEFLOW_STREAM_SSE)
+            __m128 vk = _mm_set1_ps(k), vb = _mm_set1_ps(b);
+            for (; i + 4 <= n; i += 4)
+                _mm_storeu_ps(out + i, _mm_add_ps(_mm_mul_ps(_mm_loadu_ps(a + i), vk), vb));
+#endif
+            for (; i < n; i++)
+                out[i] = a[i] * k + b;
+        }
+
+        inline float sum(const float* a, size_t n)
+        {
+            size_t i = 0;
+            float s = 0.f;
+#if defined(__AVX__)
+            __m256 acc = _mm256_setzero_ps();
+            for (; i + 8 <= n; i += 8)
+                acc = _mm256_add_ps(acc, _mm256_loadu_ps(a + i));
+            alignas(32) float lanes[8];
+            _mm256_store_ps(lanes, acc);
+            for (float l : lanes)
+                s += l;
+#elif defined(IMNODEFLOW_STREAM_SSE)
+            __m128 acc = _mm_setzero_ps();
+            for (; i + 4 <= n; i += 4)
+                acc = _mm_add_ps(acc, _mm_loadu_ps(a + i));
+            alignas(16) float lanes[4];
+            _mm_store_ps(lanes, acc);
+            for (float l : lanes)
+                s += l;
+#endif
+            for (; i < n; i++)
+                s += a[i];
+            return s;
+        }
+
+        inline Stream<float> add(const Stream<float>& a, const Stream<float>& b)
+        {
+            Stream<float> out(a.size() < b.size() ? a.size() : b.size());
+            add(a.data(), b.data(), out.mutableData(), out.size());
+            return out;
+        }
+
+        inline Stream<float> sub(const Stream<float>& a, const Stream<float>& b)
+        {
+            Stream<float> out(a.size() < b.size() ? a.size() : b.size());
+            sub(a.data(), b.data(), out.mutableData(), out.size());
+            return out;
+        }
+
+        inline Stream<float> mul(const Stream<float>& a, const Stream<float>& b)
+        {
+            Stream<float> out(a.size() < b.size() ? a.size() : b.size());
+            mul(a.data(), b.data(), out.mutableData(), out.size());
+            return out;
+        }
+
+        inline Stream<float> scaleAdd(const Stream<float>& a, float k, float b)
+        {
+            Stream<float> out(a.size());
+            scaleAdd(a.data(), k, b, out.mutableData(), out.size());
+            return out;
+        }
+
+        inline float sum(const Stream<float>& a)
+        {
+            return sum(a.data(), a.size());
+        }
+    }
+}
+
+#undef IMNODEFLOW_STREAM_SSE
@@ -0,0 +1,98 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <iterator>
+#include <memory>
+#include <mutex>
+#include <type_traits>
+#include <unordered_map>
+
+/**
+ * @brief Set of unique style objects shared by everything using them
+ * @details Styles are compared bytewise, so equal styles built separately resolve to the same object.
+ *          The registry only keeps weak references: a style is freed when nothing uses it anymore.
+ *          Interned styles are shared and immutable, they must be copied to be modified.
+ * @tparam S Type of the styles, trivially copyable without padding
+ */
+template<typename S>
+class StyleRegistry
+{
+    static_assert(std::is_trivially_copyable<S>::value, "Styles are compared bytewise");
+public:
+    /**
+     * @brief Get the shared instance of a style
+     * @param style Value of the style
+     * @return Shared pointer to a style equal to "style", created if none is alive
+     */
+    static std::shared_ptr<const S> intern(const S& style);
+
+    /**
+     * @brief Get the number of interned styles still alive
+     */
+    static size_t size();
+private:
+    struct Storage
+    {
+        std::mutex mutex;
+        std::unordered_multimap<uint64_t, std::weak_ptr<const S>> styles;
+        size_t pruneAt = 64;
+    };
+
+    static Storage& storage() { static Storage s; return s; }
+
+    static uint64_t hash(const S& style)
+    {
+        // FNV-1a
+        uint64_t h = 14695981039346656037ull;
+        const auto* bytes = reinterpret_cast<const unsigned char*>(&style);
+        for (size_t i = 0; i < sizeof(S); i++)
+            h = (h ^ bytes[i]) * 1099511628211ull;
+        return h;
+    }
+};
+
+template<typename S>
+inline std::shared_ptr<const S> StyleRegistry<S>::intern(const S& style)
+{
+    Storage& s = storage();
+    uint64_t h = hash(style);
+    std::lock_guard<std::mutex> lock(s.mutex);
+    auto range = s.styles.equal_range(h);
+    for (auto it = range.first; it != range.second;)
+    {
+        std::shared_ptr<const S> found = it->second.lock();
+        if (!found)
+        {
+            it = s.styles.erase(it);
+            continue;
+        }
+        if (std::memcmp(found.get(), &style, sizeof(S)) == 0)
+            return found;
+        ++it;
+    }
+
+    // Not make_shared: the weak reference would keep the whole style allocated
+    std::shared_ptr<const S> created(new S(style));
+    s.styles.emplace(h, created);
+    if (s.styles.size() >= s.pruneAt)
+    {
+        for (auto it = s.styles.begin(); it != s.styles.end();)
+            it = it->second.expired() ? s.styles.erase(it) : std::next(it);
+        s.pruneAt = std::max<size_t>(64, s.styles.size() * 2);
+    }
+    return created;
+}
+
+template<typename S>
+inline size_t StyleRegistry<S>::size()
+{
+    Storage& s = storage();
+    std::lock_guard<std::mutex> lock(s.mutex);
+    size_t n = 0;
+    for (auto& e : s.styles)
+        n += !e.second.expired();
+    return n;
+}
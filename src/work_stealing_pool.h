@@ -0,0 +1,276 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/**
+ * @brief Thread pool running graphs of dependent tasks
+ * @details Each worker owns a queue, pops its newest task and steals the oldest ones from the others when empty.
+ *          The thread calling run() takes part as worker 0, and is the only one running "pinned" tasks.
+ *          Workers without work spin briefly, then sleep until a task is pushed or the run ends.
+ */
+class WorkStealingPool
+{
+public:
+    typedef uint32_t Task;
+    /// @brief Tasks with this bit set only run on the thread that called run()
+    static constexpr Task PinnedTask = 0x80000000u;
+
+    explicit WorkStealingPool(unsigned threads);
+    ~WorkStealingPool();
+    WorkStealingPool(const WorkStealingPool&) = delete;
+    WorkStealingPool& operator=(const WorkStealingPool&) = delete;
+
+    /**
+     * @brief Run tasks until "total" of them are completed
+     * @details If a task throws, the tasks not started yet are dropped and the exception is rethrown here,
+     *          once all the workers are done with the tasks they were running.
+     * @param seeds Tasks ready to run
+     * @param total Number of tasks that will be executed, including the ones pushed while running
+     * @param exec Executes a task (without the pinned bit) on the given worker, can push the tasks it unlocks
+     */
+    void run(const std::vector<Task>& seeds, size_t total, const std::function<void(Task task, unsigned worker)>& exec);
+
+    /**
+     * @brief Push a ready task, must be called from inside run()
+     * @param worker Worker pushing the task
+     * @param task Task to push, optionally with the pinned bit
+     */
+    void push(unsigned worker, Task task);
+
+    [[nodiscard]] unsigned size() const { return (unsigned)m_queues.size(); }
+private:
+    struct Queue
+    {
+        std::mutex mutex;
+        std::deque<Task> tasks;
+    };
+
+    /// @brief Number of unsuccessful attempts to find a task before sleeping
+    static constexpr unsigned SpinCount = 64;
+
+    bool pop(unsigned worker, Task& task);
+    bool steal(unsigned thief, Task& task);
+    void work(unsigned worker);
+    void workerLoop(unsigned worker);
+    bool runnable(unsigned worker) const;
+    void park(unsigned worker);
+    void wakeAll();
+
+    std::vector<std::unique_ptr<Queue>> m_queues;
+    Queue m_pinned;
+    std::vector<std::thread> m_threads;
+
+    std::mutex m_mutex;
+    std::condition_variable m_wake;     // New run or stop
+    std::condition_variable m_taskWake; // Task pushed, run finished or aborted
+    std::condition_variable m_idle;     // Worker left the run
+    uint64_t m_generation = 0;
+    unsigned m_busy = 0;
+    bool m_stop = false;
+    std::exception_ptr m_error;
+
+    const std::function<void(Task, unsigned)>* m_exec = nullptr;
+    std::atomic<size_t> m_remaining{0};
+    std::atomic<size_t> m_queued{0}, m_pinnedQueued{0};
+    std::atomic<unsigned> m_sleepers{0};
+    std::atomic<bool> m_abort{false};
+};
+
+inline WorkStealingPool::WorkStealingPool(unsigned threads)
+{
+    if (threads == 0) threads = 1;
+    for (unsigned i = 0; i < threads; i++)
+        m_queues.emplace_back(std::make_unique<Queue>());
+    for (unsigned i = 1; i < threads; i++)
+        m_threads.emplace_back(&WorkStealingPool::workerLoop, this, i);
+}
+
+inline WorkStealingPool::~WorkStealingPool()
+{
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_stop = true;
+    }
+    m_wake.notify_all();
+    for (auto& t : m_threads)
+        t.join();
+}
+
+inline void WorkStealingPool::run(const std::vector<Task>& seeds, size_t total, const std::function<void(Task, unsigned)>& exec)
+{
+    if (total == 0)
+        return;
+
+    // Workers only read m_exec after popping a task, and tasks are pushed after this write
+    m_exec = &exec;
+    m_abort.store(false);
+    m_remaining.store(total);
+    for (Task t : seeds)
+        push(0, t);
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_generation++;
+        m_busy = (unsigned)m_threads.size();
+    }
+    m_wake.notify_all();
+
+    work(0);
+
+    // exec must outlive the tasks still running on the other workers
+    std::exception_ptr error;
+    {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        m_idle.wait(lock, [&] { return m_busy == 0; });
+        error = m_error;
+        m_error = nullptr;
+    }
+    if (error)
+    {
+        // Drop the tasks left behind by the aborted run
+        for (auto& q : m_queues)
+            q->tasks.clear();
+        m_pinned.tasks.clear();
+        m_queued.store(0);
+        m_pinnedQueued.store(0);
+        std::rethrow_exception(error);
+    }
+}
+
+inline void WorkStealingPool::push(unsigned worker, Task task)
+{
+    bool pinned = task & PinnedTask;
+    Queue& q = pinned ? m_pinned : *m_queues[worker];
+    {
+        std::lock_guard<std::mutex> lock(q.mutex);
+        q.tasks.push_back(task);
+    }
+    (pinned ? m_pinnedQueued : m_queued).fetch_add(1);
+    // Sleepers register before checking the counters, so either they see the task or we see them
+    if (m_sleepers.load() > 0)
+        wakeAll();
+}
+
+inline bool WorkStealingPool::pop(unsigned worker, Task& task)
+{
+    if (worker == 0)
+    {
+        std::lock_guard<std::mutex> lock(m_pinned.mutex);
+        if (!m_pinned.tasks.empty())
+        {
+            task = m_pinned.tasks.front() & ~PinnedTask;
+            m_pinned.tasks.pop_front();
+            m_pinnedQueued.fetch_sub(1);
+            return true;
+        }
+    }
+
+    Queue& q = *m_queues[worker];
+    std::lock_guard<std::mutex> lock(q.mutex);
+    if (q.tasks.empty())
+        return false;
+    task = q.tasks.back();
+    q.tasks.pop_back();
+    m_queued.fetch_sub(1);
+    return true;
+}
+
+inline bool WorkStealingPool::steal(unsigned thief, Task& task)
+{
+    for (unsigned i = 1; i < m_queues.size(); i++)
+    {
+        Queue& q = *m_queues[(thief + i) % m_queues.size()];
+        std::lock_guard<std::mutex> lock(q.mutex);
+        if (q.tasks.empty())
+            continue;
+        task = q.tasks.front();
+        q.tasks.pop_front();
+        m_queued.fetch_sub(1);
+        return true;
+    }
+    return false;
+}
+
+inline void WorkStealingPool::work(unsigned worker)
+{
+    Task task;
+    unsigned misses = 0;
+    while (m_remaining.load() > 0 && !m_abort.load())
+    {
+        if (pop(worker, task) || steal(worker, task))
+        {
+            misses = 0;
+            try
+            {
+                (*m_exec)(task, worker);
+            }
+            catch (...)
+            {
+                {
+                    std::lock_guard<std::mutex> lock(m_mutex);
+                    if (!m_error)
+                        m_error = std::current_exception();
+                }
+                m_abort.store(true);
+                wakeAll();
+            }
+            if (m_remaining.fetch_sub(1) == 1)
+                wakeAll();
+        }
+        else if (++misses < SpinCount)
+            std::this_thread::yield();
+        else
+            park(worker);
+    }
+}
+
+inline bool WorkStealingPool::runnable(unsigned worker) const
+{
+    return m_remaining.load() == 0 || m_abort.load() || m_queued.load() > 0 || (worker == 0 && m_pinnedQueued.load() > 0);
+}
+
+inline void WorkStealingPool::park(unsigned worker)
+{
+    std::unique_lock<std::mutex> lock(m_mutex);
+    m_sleepers.fetch_add(1);
+    m_taskWake.wait(lock, [&] { return runnable(worker); });
+    m_sleepers.fetch_sub(1);
+}
+
+inline void WorkStealingPool::wakeAll()
+{
+    // Taking the lock orders the notification after a sleeper's last check
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+    }
+    m_taskWake.notify_all();
+}
+
+inline void WorkStealingPool::workerLoop(unsigned worker)
+{
+    uint64_t seen = 0;
+    while (true)
+    {
+        {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            m_wake.wait(lock, [&] { return m_stop || m_generation != seen; });
+            if (m_stop)
+                return;
+            seen = m_generation;
+        }
+        work(worker);
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_busy--;
+        }
+        m_idle.notify_all();
+    }
+}
@@ -0,0 +1,99 @@
+#include "ImNodeFlow.h"
+#include "test.h"
+
+#include <algorithm>
+#include <random>
+#include <unordered_set>
+
+using namespace ImFlow;
+
+// Cost of rejecting cycles on random DAGs (100k links): building them with the check on every link,
+// and single queries using the topological order against a plain search of everything downstream.
+
+class Mix : public BaseNode
+{
+public:
+    Mix()
+    {
+        for (int i = 0; i < 5; i++)
+            addIN_uid<int>(i, "in", 0, ConnectionFilter::None());
+        addOUT<int>("out")->behaviour([]() { return 0; });
+    }
+};
+
+// Breadth-first search without the order, as a check without it would do
+static bool reaches(BaseNode* from, BaseNode* target)
+{
+    std::vector<BaseNode*> queue{from};
+    std::unordered_set<BaseNode*> seen{from};
+    for (size_t head = 0; head < queue.size(); head++)
+    {
+        if (queue[head] == target)
+            return true;
+        for (auto& l : queue[head]->getOuts()[0]->getLinks())
+            if (auto link = l.lock(); link && seen.insert(link->right()->getParent()).second)
+                queue.push_back(link->right()->getParent());
+    }
+    return false;
+}
+
+// Builds a DAG where each node reads 5 nodes shortly before it in a hidden order, links created in random order.
+// With "shuffled" the creation order of the nodes is unrelated to the hidden order, so the topological order has to
+// be repaired as the links come (worst case), otherwise the nodes are created in dataflow order (loading a graph).
+static void run(int nodes, bool shuffled)
+{
+    const int inputs = 5;
+    ImNodeFlow inf;
+    inf.rejectCycles(true);
+    std::vector<BaseNode*> all;
+    for (int i = 0; i < nodes; i++)
+        all.push_back(inf.addNode<Mix>({0, 0}).get());
+
+    std::mt19937 rng(42);
+    std::vector<BaseNode*> hidden = all;
+    if (shuffled)
+        std::shuffle(hidden.begin(), hidden.end(), rng);
+    std::vector<std::pair<Pin*, Pin*>> links;
+    for (int i = 1; i < nodes; i++)
+        for (int k = 0; k < inputs; k++)
+        {
+            int j = std::max(0, i - 64) + (int)(rng() % std::min(i, 64));
+            links.emplace_back(hidden[j]->outPin("out"), hidden[i]->inPin(k));
+        }
+    std::shuffle(links.begin(), links.end(), rng);
+
+    size_t created = 0;
+    double build = test::time(1, [&]() {
+        for (auto& l : links)
+        {
+            l.first->createLink(l.second);
+            created += l.second->isConnected();
+        }
+    });
+    std::printf("%d nodes%s, %zu links created\n", nodes, shuffled ? " (shuffled)" : "", created);
+    test::report("  createLink() with cycle check, per link", build / (double)links.size());
+
+    // Queries between random nodes, about half of them closing a cycle
+    std::vector<std::pair<BaseNode*, BaseNode*>> queries;
+    for (int i = 0; i < 1000; i++)
+        queries.emplace_back(all[rng() % nodes], all[rng() % nodes]);
+    size_t cycles = 0, plainCycles = 0;
+    double ordered = test::time(1, [&]() {
+        for (auto& q : queries)
+            cycles += inf.wouldCreateCycle(q.first->outPin("out"), q.second->inPin(0));
+    });
+    double plain = test::time(1, [&]() {
+        for (auto& q : queries)
+            plainCycles += q.first == q.second || reaches(q.second, q.first);
+    });
+    std::printf("  %zu of %zu queries would close a cycle (plain search: %zu)\n", cycles, queries.size(), plainCycles);
+    test::report("  wouldCreateCycle(), per query", ordered / (double)queries.size());
+    test::report("  plain downstream search, per query", plain / (double)queries.size());
+}
+
+int main()
+{
+    run(20000, false);
+    run(2000, true);
+    return 0;
+}
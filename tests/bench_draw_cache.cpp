@@ -0,0 +1,56 @@
+#include "ImNodeFlow.h"
+#include "headless.h"
+#include "test.h"
+
+using namespace ImFlow;
+
+// Frame time of the editor with the node background and grid caches enabled and disabled.
+// Nothing moves between frames, so every enabled cache is replayed.
+
+class Passthrough : public BaseNode
+{
+public:
+    Passthrough()
+    {
+        setTitle("Passthrough");
+        setStyle(NodeStyle::cyan());
+        addIN<int>("In", 0, ConnectionFilter::SameType());
+        addOUT<int>("Out")->behaviour([this]() { return getInVal<int>("In"); });
+    }
+};
+
+static void measure(test::Headless& imgui, bool nodeCache, bool gridCache)
+{
+    ImNodeFlow inf("bench");
+    inf.nodeDrawCache(nodeCache);
+    inf.gridDrawCache(gridCache);
+    // 20 x 20 nodes in rows, all on screen at zoom 1 with a 1920 x 1080 display
+    std::vector<std::shared_ptr<Passthrough>> nodes;
+    for (int y = 0; y < 20; y++)
+        for (int x = 0; x < 20; x++)
+        {
+            nodes.push_back(inf.addNode<Passthrough>({x * 95.f, y * 52.f}));
+            if (x > 0)
+                nodes[nodes.size() - 2]->outPin("Out")->createLink(nodes.back()->inPin("In"));
+        }
+
+    int vertices = 0;
+    for (int i = 0; i < 10; i++)
+        vertices = imgui.frame([&]() { inf.update(); });
+    double ns = test::time(100, [&]() { imgui.frame([&]() { inf.update(); }); });
+
+    char line[96];
+    std::snprintf(line, sizeof(line), "  node cache %s, grid cache %s (%d vertices)",
+                  nodeCache ? "on " : "off", gridCache ? "on " : "off", vertices);
+    test::report(line, ns);
+}
+
+int main()
+{
+    test::Headless imgui;
+    std::printf("400 nodes, 380 links, full frame\n");
+    for (bool nodeCache : {false, true})
+        for (bool gridCache : {false, true})
+            measure(imgui, nodeCache, gridCache);
+    return 0;
+}
@@ -0,0 +1,109 @@
+#include "ImNodeFlow.h"
+#include "test.h"
+
+#include <algorithm>
+#include <string>
+
+using namespace ImFlow;
+
+// Evaluation cost of a deep chain and of a wide fan-in, with the cost of the recursion checks they need.
+// The string blacklist used before evaluation epochs is reproduced for reference.
+
+class Increment : public BaseNode
+{
+public:
+    Increment()
+    {
+        addIN<int>("in", 0, ConnectionFilter::None());
+        addOUT<int>("out")->behaviour([this]() { return getInVal<int>("in") + 1; });
+    }
+};
+
+class Source : public BaseNode
+{
+public:
+    Source() { addOUT<int>("out")->behaviour([]() { return 1; }); }
+};
+
+class Sum : public BaseNode
+{
+public:
+    explicit Sum(int inputs) :m_inputs(inputs)
+    {
+        for (int i = 0; i < inputs; i++)
+            addIN_uid<int>(i, "in", 0, ConnectionFilter::None());
+        addOUT<int>("out")->behaviour([this]() {
+            int s = 0;
+            for (int i = 0; i < m_inputs; i++)
+                s += getInVal<int>(i);
+            return s;
+        });
+    }
+private:
+    int m_inputs;
+};
+
+// One pull of every output pin, checked against the per-frame blacklist as OutPin::val() used to
+static double legacyBlacklist(const std::vector<Pin*>& pins)
+{
+    std::vector<std::string> blacklist;
+    return test::time(10, [&]() {
+        for (Pin* p : pins)
+        {
+            std::string key = std::to_string(p->getUid()) + std::to_string(p->getParent()->getUID());
+            if (std::find(blacklist.begin(), blacklist.end(), key) == blacklist.end())
+                blacklist.push_back(std::move(key));
+        }
+        blacklist.clear();
+    });
+}
+
+static void deepChain(int n)
+{
+    ImNodeFlow inf;
+    std::vector<Pin*> outs;
+    BaseNode* prev = inf.addNode<Source>({0, 0}).get();
+    outs.push_back(prev->outPin("out"));
+    for (int i = 0; i < n; i++)
+    {
+        auto node = inf.addNode<Increment>({0, 0});
+        prev->outPin("out")->createLink(node->inPin("in"));
+        outs.push_back(node->outPin("out"));
+        prev = node.get();
+    }
+    inf.evaluate();
+
+    std::printf("Deep chain, %d nodes\n", n);
+    test::report("  evaluate()", test::time(100, [&]() { inf.evaluate(); }));
+    test::report("  evaluate(sink)", test::time(100, [&]() { inf.evaluate({prev->outPin("out")}); }));
+    test::report("  legacy blacklist checks (reproduced)", legacyBlacklist(outs));
+}
+
+static void wideFanIn(int n)
+{
+    ImNodeFlow inf;
+    std::vector<Pin*> outs;
+    auto sum = inf.addNode<Sum>({0, 0}, n);
+    for (int i = 0; i < n; i++)
+    {
+        auto src = inf.addNode<Source>({0, 0});
+        src->outPin("out")->createLink(sum->inPin(i));
+        outs.push_back(src->outPin("out"));
+    }
+    outs.push_back(sum->outPin("out"));
+    inf.evaluate();
+
+    std::printf("Wide fan-in, %d inputs\n", n);
+    test::report("  evaluate()", test::time(100, [&]() { inf.evaluate(); }));
+    test::report("  legacy blacklist checks (reproduced)", legacyBlacklist(outs));
+}
+
+int main()
+{
+    for (int n : {1000, 10000})
+    {
+        deepChain(n);
+        wideFanIn(n);
+    }
+    return 0;
+}
@@ -0,0 +1,59 @@
+#include "ImNodeFlow.h"
+#include "test.h"
+
+#include <string>
+
+using namespace ImFlow;
+
+// Reading the 64 inputs of a node by name and by handle, and by handle once the pins have moved.
+
+class Wide : public BaseNode
+{
+public:
+    Wide()
+    {
+        for (int i = 0; i < 64; i++)
+        {
+            names.push_back("in" + std::to_string(i));
+            handles.push_back(addIN<int>(names.back(), i, ConnectionFilter::None()));
+        }
+    }
+
+    int byName()
+    {
+        int s = 0;
+        for (const std::string& n : names)
+            s += getInVal<int>(n.c_str());
+        return s;
+    }
+
+    int byHandle()
+    {
+        int s = 0;
+        for (InPinHandle<int> h : handles)
+            s += getInVal(h);
+        return s;
+    }
+
+    std::vector<std::string> names;
+    std::vector<InPinHandle<int>> handles;
+};
+
+// Keeps the reads from being optimized out
+static volatile int sink;
+
+int main()
+{
+    ImNodeFlow inf;
+    auto n = inf.addNode<Wide>({0, 0});
+
+    std::printf("64 inputs, all read once\n");
+    test::report("  by name", test::time(10000, [&]() { sink = n->byName(); }));
+    test::report("  by handle", test::time(10000, [&]() { sink = n->byHandle(); }));
+
+    // Every handle after the first is off by one, resolved by UID
+    n->dropIN("in0");
+    n->handles.erase(n->handles.begin());
+    test::report("  by handle, after dropping the first pin", test::time(10000, [&]() { sink = n->byHandle(); }));
+    return 0;
+}
@@ -0,0 +1,65 @@
+#include "ImNodeFlow.h"
+#include "test.h"
+
+#include <algorithm>
+#include <cmath>
+#include <thread>
+
+using namespace ImFlow;
+
+// Scaling of evaluateParallel() with the number of threads, on independent chains of thread-safe nodes
+// doing some arithmetic each.
+
+class Work : public BaseNode
+{
+public:
+    Work()
+    {
+        setThreadSafe(true);
+        addIN<double>("in", 0.0, ConnectionFilter::None());
+        addOUT<double>("out")->behaviour([this]() {
+            double x = getInVal<double>("in");
+            for (int i = 0; i < 2000; i++)
+                x = std::sin(x) + 1.0;
+            return x;
+        });
+    }
+};
+
+int main()
+{
+    ImNodeFlow inf;
+    const int chains = 64, length = 32;
+    for (int c = 0; c < chains; c++)
+    {
+        auto prev = inf.addNode<Work>({0, 0});
+        for (int i = 1; i < length; i++)
+        {
+            auto node = inf.addNode<Work>({0, 0});
+            prev->outPin("out")->createLink(node->inPin("in"));
+            prev = node;
+        }
+    }
+
+    std::printf("%d chains of %d nodes\n", chains, length);
+    inf.evaluate();
+    double serial = test::time(5, [&]() { inf.evaluate(); });
+    test::report("  evaluate()", serial);
+    // Powers of two, then all the cores
+    unsigned cores = std::max(1u, std::thread::hardware_concurrency());
+    std::vector<unsigned> counts;
+    for (unsigned n = 1; n < cores; n *= 2)
+        counts.push_back(n);
+    counts.push_back(cores);
+    for (unsigned n : counts)
+    {
+        inf.setEvaluationThreads(n);
+        inf.evaluateParallel();
+        double t = test::time(5, [&]() { inf.evaluateParallel(); });
+        char name[64];
+        std::snprintf(name, sizeof(name), "  evaluateParallel(), %u thread(s)", n);
+        test::report(name, t);
+        std::printf("%-48s %12.2fx\n", "    speedup", serial / t);
+    }
+    return 0;
+}
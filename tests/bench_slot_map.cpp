@@ -0,0 +1,88 @@
+#include "ImNodeFlow.h"
+#include "test.h"
+
+#include <algorithm>
+#include <random>
+
+// Node storage with one million entries: the slot map used by ImNodeFlow against the hash map it replaced.
+// Values are shared pointers, as nodes are stored.
+
+struct Payload
+{
+    float x = 0.f, y = 0.f;
+};
+
+static constexpr size_t N = 1000000;
+// Keeps the reads from being optimized out
+static volatile float sink;
+
+static void slotMap(const std::vector<size_t>& order)
+{
+    SlotMap<std::shared_ptr<Payload>> map;
+    std::vector<SlotMap<std::shared_ptr<Payload>>::Handle> handles(N);
+    double insert = test::time(1, [&]() {
+        for (size_t i = 0; i < N; i++)
+            handles[i] = map.insert(std::make_shared<Payload>());
+    });
+    float sum = 0.f;
+    double iterate = test::time(10, [&]() {
+        for (auto& p : map)
+            sum += p->x;
+    });
+    double lookup = test::time(1, [&]() {
+        for (size_t i : order)
+            sum += (*map.get(handles[i]))->y;
+    });
+    double erase = test::time(1, [&]() {
+        for (size_t i : order)
+            map.erase(handles[i]);
+    });
+
+    sink = sum;
+    std::printf("SlotMap\n");
+    test::report("  insert 1M", insert);
+    test::report("  iterate 1M", iterate);
+    test::report("  lookup 1M, random order", lookup);
+    test::report("  erase 1M, random order", erase);
+}
+
+static void unorderedMap(const std::vector<size_t>& order)
+{
+    std::unordered_map<uint64_t, std::shared_ptr<Payload>> map;
+    double insert = test::time(1, [&]() {
+        for (size_t i = 0; i < N; i++)
+            map.emplace(i, std::make_shared<Payload>());
+    });
+    float sum = 0.f;
+    double iterate = test::time(10, [&]() {
+        for (auto& p : map)
+            sum += p.second->x;
+    });
+    double lookup = test::time(1, [&]() {
+        for (size_t i : order)
+            sum += map.find(i)->second->y;
+    });
+    double erase = test::time(1, [&]() {
+        for (size_t i : order)
+            map.erase(i);
+    });
+
+    sink = sum;
+    std::printf("std::unordered_map\n");
+    test::report("  insert 1M", insert);
+    test::report("  iterate 1M", iterate);
+    test::report("  lookup 1M, random order", lookup);
+    test::report("  erase 1M, random order", erase);
+}
+
+int main()
+{
+    std::vector<size_t> order(N);
+    for (size_t i = 0; i < N; i++)
+        order[i] = i;
+    std::shuffle(order.begin(), order.end(), std::mt19937(42));
+
+    slotMap(order);
+    unorderedMap(order);
+    return 0;
+}
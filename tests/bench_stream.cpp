@@ -0,0 +1,78 @@
+#include "ImNodeFlow.h"
+#include "test.h"
+
+using namespace ImFlow;
+
+// Cost of passing 64k-sample buffers through a chain of nodes, as std::vector<float> (copied at each pin)
+// and as Stream<float> (shared), and throughput of the stream kernels against plain loops.
+
+static constexpr size_t Samples = 64 * 1024;
+
+template<typename Buffer>
+class Source : public BaseNode
+{
+public:
+    Buffer data;
+
+    explicit Source(Buffer d) :data(std::move(d)) { addOUT<Buffer>("out")->behaviour([this]() { return data; }); }
+};
+
+// Forwards its input, as a node only reading the samples would
+template<typename Buffer>
+class Pass : public BaseNode
+{
+public:
+    Pass()
+    {
+        addIN<Buffer>("in", Buffer(), ConnectionFilter::None());
+        addOUT<Buffer>("out")->behaviour([this]() { return getInVal<Buffer>("in"); });
+    }
+};
+
+template<typename Buffer>
+static double chain(Buffer data, int length)
+{
+    ImNodeFlow inf;
+    BaseNode* prev = inf.addNode<Source<Buffer>>({0, 0}, std::move(data)).get();
+    for (int i = 0; i < length; i++)
+    {
+        auto node = inf.addNode<Pass<Buffer>>({0, 0});
+        prev->outPin("out")->createLink(node->inPin("in"));
+        prev = node.get();
+    }
+    inf.evaluate();
+    return test::time(100, [&]() { inf.evaluate(); });
+}
+
+int main()
+{
+    Stream<float> a(Samples), b(Samples), out(Samples);
+    for (size_t i = 0; i < Samples; i++)
+    {
+        a.mutableData()[i] = (float)i;
+        b.mutableData()[i] = 1.f;
+    }
+
+    std::printf("Chain of 16 nodes, %zu samples\n", Samples);
+    test::report("  std::vector<float> pins", chain(std::vector<float>(a.begin(), a.end()), 16));
+    test::report("  Stream<float> pins", chain(a, 16));
+
+    std::printf("Kernels, %zu samples\n", Samples);
+    float* o = out.mutableData();
+    volatile float sink = 0.f;
+    test::report("  add, loop", test::time(1000, [&]() {
+        for (size_t i = 0; i < Samples; i++)
+            o[i] = a[i] + b[i];
+        sink = o[Samples - 1];
+    }));
+    test::report("  add, StreamKernels", test::time(1000, [&]() { StreamKernels::add(a.data(), b.data(), o, Samples); sink = o[Samples - 1]; }));
+    test::report("  sum, loop", test::time(1000, [&]() {
+        float s = 0.f;
+        for (size_t i = 0; i < Samples; i++)
+            s += a[i];
+        sink = s;
+    }));
+    test::report("  sum, StreamKernels", test::time(1000, [&]() { sink = StreamKernels::sum(a); }));
+    (void)sink;
+    return 0;
+}
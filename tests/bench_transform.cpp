@@ -0,0 +1,39 @@
+#include "ImNodeFlow.h"
+#include "test.h"
+
+// Throughput of the vertex transform and index rebase used when appending the canvas' draw data to the host window,
+// against plain loops, for 1k to 1M vertices.
+
+int main()
+{
+    for (int count : {1000, 10000, 100000, 1000000})
+    {
+        std::vector<ImDrawVert> src(count), dst(count);
+        std::vector<ImDrawIdx> isrc(count * 3 / 2), idst(isrc.size());
+        for (int i = 0; i < count; i++)
+            src[i].pos = ImVec2((float)i, (float)i);
+        ImVec2 origin(10.f, 20.f);
+        size_t iterations = 100000000 / (size_t)count;
+
+        std::printf("%d vertices, %zu indices\n", count, isrc.size());
+        test::report("  vertices, loop", test::time(iterations, [&]() {
+            for (int i = 0; i < count; i++)
+            {
+                dst[i].uv = src[i].uv;
+                dst[i].col = src[i].col;
+                dst[i].pos = src[i].pos * 0.5f + origin;
+            }
+        }));
+        test::report("  vertices, TransformVertices()", test::time(iterations, [&]() {
+            TransformVertices(src.data(), dst.data(), count, origin, 0.5f);
+        }));
+        test::report("  indices, loop", test::time(iterations, [&]() {
+            for (size_t i = 0; i < isrc.size(); i++)
+                idst[i] = (ImDrawIdx)(isrc[i] + 7);
+        }));
+        test::report("  indices, RebaseIndices()", test::time(iterations, [&]() {
+            RebaseIndices(isrc.data(), idst.data(), (int)isrc.size(), 7);
+        }));
+    }
+    return 0;
+}
@@ -0,0 +1,96 @@
+#include "ImNodeFlow.h"
+#include "test.h"
+
+#include <atomic>
+#include <cstdlib>
+#include <new>
+
+using namespace ImFlow;
+
+// Heap allocations and time per frame for a large value (1M floats) produced by value, in place,
+// and shared with many readers as a Snapshot.
+
+static std::atomic<size_t> g_allocations{0};
+
+void* operator new(size_t size)
+{
+    g_allocations++;
+    if (void* p = std::malloc(size ? size : 1))
+        return p;
+    throw std::bad_alloc();
+}
+void operator delete(void* p) noexcept { std::free(p); }
+void operator delete(void* p, size_t) noexcept { std::free(p); }
+
+typedef std::vector<float> Buffer;
+static constexpr size_t Size = 1 << 20;
+
+class ByValue : public BaseNode
+{
+public:
+    ByValue()
+    {
+        addOUT<Buffer>("out")->behaviour([]() { return Buffer(Size, 1.f); });
+    }
+};
+
+class InPlace : public BaseNode
+{
+public:
+    InPlace()
+    {
+        addOUT<Buffer>("out")->behaviourInPlace([](Buffer& out) { out.assign(Size, 1.f); });
+    }
+};
+
+class Shared : public BaseNode
+{
+public:
+    Shared()
+    {
+        // Rebuilt each frame, the readers only copy the pointer
+        addOUT<Snapshot<Buffer>>("out")->behaviour([]() { return std::make_shared<const Buffer>(Size, 1.f); });
+    }
+};
+
+// Reads its input, copying it as a node keeping its own version would
+template<typename V>
+class Reader : public BaseNode
+{
+public:
+    Reader()
+    {
+        addIN<V>("in", V(), ConnectionFilter::None());
+        addOUT<V>("out")->behaviour([this]() { return getInVal<V>("in"); });
+    }
+};
+
+template<typename Producer, typename V>
+static void measure(const char* name, int readers)
+{
+    ImNodeFlow inf;
+    auto src = inf.addNode<Producer>({0, 0});
+    for (int i = 0; i < readers; i++)
+        src->outPin("out")->createLink(inf.addNode<Reader<V>>({0, 0})->inPin("in"));
+    inf.evaluate();
+
+    const int frames = 20;
+    size_t before = g_allocations;
+    double ns = test::time(frames, [&]() { inf.evaluate(); });
+    char line[96];
+    std::snprintf(line, sizeof(line), "  %s, %d readers", name, readers);
+    test::report(line, ns);
+    std::printf("%-48s %12.1f\n", "    allocations per frame", (double)(g_allocations - before) / frames);
+}
+
+int main()
+{
+    std::printf("1M floats per frame\n");
+    for (int readers : {0, 8})
+    {
+        measure<ByValue, Buffer>("behaviour()", readers);
+        measure<InPlace, Buffer>("behaviourInPlace()", readers);
+        measure<Shared, Snapshot<Buffer>>("Snapshot", readers);
+    }
+    return 0;
+}
@@ -0,0 +1,71 @@
+#include "ImNodeFlow.h"
+#include "headless.h"
+#include "test.h"
+
+using namespace ImFlow;
+
+// Frame time of the editor drawn through a nested context (copy of the events, transform of the vertices)
+// and drawn directly into the host context, at several zoom levels.
+
+class Sum : public BaseNode
+{
+public:
+    Sum()
+    {
+        setTitle("Sum");
+        m_a = addIN<int>("A", 0, ConnectionFilter::SameType());
+        m_b = addIN<int>("B", 0, ConnectionFilter::SameType());
+        addOUT<int>("Out")->behaviour([this]() { return getInVal(m_a) + getInVal(m_b) + m_k; });
+    }
+
+    void draw() override
+    {
+        ImGui::SetNextItemWidth(80.f * getHandler()->getDrawScale());
+        ImGui::InputInt("##k", &m_k);
+    }
+private:
+    InPinHandle<int> m_a, m_b;
+    int m_k = 1;
+};
+
+static void measure(test::Headless& imgui, bool direct, float zoom)
+{
+    ImNodeFlow inf("bench");
+    inf.directZoom(direct);
+    // Zoom reset, without animation
+    inf.getGrid().config().default_zoom = zoom;
+    inf.getGrid().config().zoom_smoothness = 1.f;
+    // 20 x 20 nodes, each one reading its left and upper neighbours
+    std::vector<std::shared_ptr<Sum>> nodes;
+    for (int y = 0; y < 20; y++)
+        for (int x = 0; x < 20; x++)
+        {
+            nodes.push_back(inf.addNode<Sum>({x * 220.f, y * 140.f}));
+            if (x > 0)
+                nodes[nodes.size() - 2]->outPin("Out")->createLink(nodes.back()->inPin("A"));
+            if (y > 0)
+                nodes[nodes.size() - 21]->outPin("Out")->createLink(nodes.back()->inPin("B"));
+        }
+
+    int vertices = 0;
+    imgui.press(inf.getGrid().config().reset_zoom_key, [&]() { inf.update(); });
+    for (int i = 0; i < 10; i++)
+        vertices = imgui.frame([&]() { inf.update(); });
+    double ns = test::time(100, [&]() { imgui.frame([&]() { inf.update(); }); });
+
+    char line[96];
+    std::snprintf(line, sizeof(line), "  %s, zoom %.2f (%d vertices)", direct ? "direct" : "nested context", zoom, vertices);
+    test::report(line, ns);
+}
+
+int main()
+{
+    test::Headless imgui;
+    std::printf("400 nodes, 760 links, full frame\n");
+    for (float zoom : {1.f, 0.5f, 0.3f})
+    {
+        measure(imgui, false, zoom);
+        measure(imgui, true, zoom);
+    }
+    return 0;
+}
@@ -0,0 +1,61 @@
+#pragma once
+
+#include <imgui.h>
+
+/**
+ * @brief ImGui context without a backend, for benchmarks drawing the editor
+ * @details The fonts are built but never uploaded, frames are rendered into draw data that nobody consumes.
+ */
+namespace test
+{
+    class Headless
+    {
+    public:
+        explicit Headless(ImVec2 displaySize = ImVec2(1920.f, 1080.f))
+        {
+            m_ctx = ImGui::CreateContext();
+            ImGuiIO& io = ImGui::GetIO();
+            io.DisplaySize = displaySize;
+            io.DeltaTime = 1.f / 60.f;
+            io.IniFilename = nullptr;
+            io.BackendFlags |= ImGuiBackendFlags_RendererHasVtxOffset;
+            io.AddMousePosEvent(displaySize.x / 2.f, displaySize.y / 2.f);
+            unsigned char* pixels;
+            int w, h;
+            io.Fonts->GetTexDataAsRGBA32(&pixels, &w, &h);
+        }
+        ~Headless() { ImGui::DestroyContext(m_ctx); }
+        Headless(const Headless&) = delete;
+        Headless& operator=(const Headless&) = delete;
+
+        /**
+         * @brief Run one frame with "f" called inside a full screen window
+         * @return Number of vertices rendered
+         */
+        template<typename F>
+        int frame(F&& f)
+        {
+            ImGui::NewFrame();
+            ImGui::SetNextWindowPos(ImVec2(0.f, 0.f));
+            ImGui::SetNextWindowSize(ImGui::GetIO().DisplaySize);
+            ImGui::Begin("Canvas", nullptr, ImGuiWindowFlags_NoDecoration);
+            f();
+            ImGui::End();
+            ImGui::Render();
+            return ImGui::GetDrawData()->TotalVtxCount;
+        }
+        /**
+         * @brief Run two frames pressing and releasing a key, with "f" called inside
+         */
+        template<typename F>
+        void press(ImGuiKey key, F&& f)
+        {
+            ImGui::GetIO().AddKeyEvent(key, true);
+            frame(f);
+            ImGui::GetIO().AddKeyEvent(key, false);
+            frame(f);
+        }
+    private:
+        ImGuiContext* m_ctx;
+    };
+}
@@ -0,0 +1,48 @@
+#pragma once
+
+#include <chrono>
+#include <cstdio>
+
+/**
+ * @brief Minimal helpers shared by the tests and the benchmarks
+ */
+namespace test
+{
+    inline int& failures() { static int n = 0; return n; }
+
+    /**
+     * @brief Exit status of a test, reports the number of failed checks
+     */
+    inline int result()
+    {
+        if (failures())
+            std::fprintf(stderr, "%d check(s) failed\n", failures());
+        return failures() != 0;
+    }
+
+    /**
+     * @brief Average duration of a call to "f" in nanoseconds
+     * @param iterations Number of calls to average over
+     */
+    template<typename F>
+    double time(size_t iterations, F&& f)
+    {
+        auto start = std::chrono::steady_clock::now();
+        for (size_t i = 0; i < iterations; i++)
+            f();
+        return std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count() / (double)iterations;
+    }
+
+    /**
+     * @brief Print one line of benchmark results
+     */
+    inline void report(const char* name, double ns)
+    {
+        if (ns >= 1e6)
+            std::printf("%-48s %12.3f ms\n", name, ns / 1e6);
+        else
+            std::printf("%-48s %12.1f ns\n", name, ns);
+    }
+}
+
+#define CHECK(cond) do { if (!(cond)) { std::fprintf(stderr, "%s:%d: CHECK(%s) failed\n", __FILE__, __LINE__, #cond); test::failures()++; } } while (0)
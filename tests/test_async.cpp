@@ -0,0 +1,223 @@
+#include "ImNodeFlow.h"
+#include "test.h"
+
+#include <stdexcept>
+#include <string>
+#include <thread>
+
+using namespace ImFlow;
+
+class Source : public BaseNode
+{
+public:
+    int value = 1;
+
+    Source() { addOUT<int>("out")->behaviour([this]() { return value; }); }
+};
+
+// Doubles its input in the background, counting the jobs started and the ones running at once
+class Double : public BaseNode
+{
+public:
+    std::atomic<int> launches{0};
+    bool fail = false;
+    static std::atomic<int> running, maxRunning;
+
+    Double()
+    {
+        addIN<int>("in", 0, ConnectionFilter::None());
+        addOUT<int>("out")->behaviourAsync([this]() {
+            launches++;
+            int v = getInVal<int>("in");
+            bool f = fail;
+            return [v, f]() {
+                int r = ++running;
+                for (int m = maxRunning; r > m && !maxRunning.compare_exchange_weak(m, r);) {}
+                std::this_thread::sleep_for(std::chrono::milliseconds(5));
+                running--;
+                if (f)
+                    throw std::runtime_error("failed");
+                return v * 2;
+            };
+        });
+    }
+
+    OutPin<int>* out() { return static_cast<OutPin<int>*>(outPin("out")); }
+};
+
+std::atomic<int> Double::running{0}, Double::maxRunning{0};
+
+// Evaluates until the pin collected its job
+static void settle(ImNodeFlow& inf, Pin* pin)
+{
+    for (int i = 0; i < 1000; i++)
+    {
+        inf.evaluate();
+        if (pin->getState() != PinState_Pending && pin->getState() != PinState_Stale)
+            return;
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+}
+
+static void relaunchOnChange()
+{
+    ImNodeFlow inf;
+    auto src = inf.addNode<Source>({0, 0});
+    auto dbl = inf.addNode<Double>({0, 0});
+    src->outPin("out")->createLink(dbl->inPin("in"));
+
+    settle(inf, dbl->out());
+    CHECK(dbl->out()->val() == 2);
+    CHECK(dbl->launches == 1);
+
+    // Same inputs: the job isn't started again
+    for (int i = 0; i < 10; i++)
+        inf.evaluate();
+    CHECK(dbl->launches == 1);
+    CHECK(dbl->out()->getState() == PinState_Ready);
+
+    src->value = 5;
+    settle(inf, dbl->out());
+    CHECK(dbl->out()->val() == 10);
+    CHECK(dbl->launches == 2);
+
+    // Parameters of the node itself are flagged with markDirty()
+    dbl->markDirty();
+    settle(inf, dbl->out());
+    CHECK(dbl->launches == 3);
+}
+
+// Length of a string input, computed in the background
+class Length : public BaseNode
+{
+public:
+    std::atomic<int> launches{0};
+
+    Length()
+    {
+        addIN<std::string>("in", "", ConnectionFilter::None());
+        addOUT<size_t>("out")->behaviourAsync([this]() {
+            launches++;
+            std::string v = getInVal<std::string>("in");
+            return [v]() { return v.size(); };
+        });
+    }
+
+    OutPin<size_t>* out() { return static_cast<OutPin<size_t>*>(outPin("out")); }
+};
+
+class Text : public BaseNode
+{
+public:
+    std::string value = "abc";
+
+    Text() { addOUT<std::string>("out")->behaviour([this]() { return value; }); }
+};
+
+struct NoEquality { int v; std::string s; };
+static_assert(IsComparable<std::string>::value, "");
+static_assert(IsComparable<std::vector<std::pair<int, std::string>>>::value, "");
+static_assert(!IsComparable<NoEquality>::value, "");
+static_assert(!IsComparable<std::vector<NoEquality>>::value, "");
+
+static void relaunchOnChangedValue()
+{
+    ImNodeFlow inf;
+    auto text = inf.addNode<Text>({0, 0});
+    auto len = inf.addNode<Length>({0, 0});
+    text->outPin("out")->createLink(len->inPin("in"));
+
+    settle(inf, len->out());
+    CHECK(len->out()->val() == 3);
+
+    // Recomputed every evaluation, but equal strings keep their version
+    for (int i = 0; i < 10; i++)
+        inf.evaluate();
+    CHECK(len->launches == 1);
+
+    text->value = "abcdef";
+    settle(inf, len->out());
+    CHECK(len->out()->val() == 6);
+    CHECK(len->launches == 2);
+}
+
+static void submitFromWorkers()
+{
+    // Every job is submitted from the workers of the parallel evaluation
+    ImNodeFlow inf;
+    inf.setEvaluationThreads(8);
+    auto src = inf.addNode<Source>({0, 0});
+    std::vector<std::shared_ptr<Double>> nodes;
+    for (int i = 0; i < 64; i++)
+    {
+        nodes.push_back(inf.addNode<Double>({0, 0}));
+        nodes.back()->setThreadSafe(true);
+        src->outPin("out")->createLink(nodes.back()->inPin("in"));
+    }
+    inf.evaluateParallel();
+    for (auto& n : nodes)
+    {
+        settle(inf, n->out());
+        CHECK(n->out()->val() == 2);
+    }
+}
+
+static void errorState()
+{
+    ImNodeFlow inf;
+    auto src = inf.addNode<Source>({0, 0});
+    auto dbl = inf.addNode<Double>({0, 0});
+    src->outPin("out")->createLink(dbl->inPin("in"));
+    settle(inf, dbl->out());
+
+    dbl->fail = true;
+    src->value = 3;
+    settle(inf, dbl->out());
+    CHECK(dbl->out()->getState() == PinState_Error);
+    CHECK(dbl->out()->getError() != nullptr);
+    CHECK(dbl->out()->val() == 2);
+
+    dbl->fail = false;
+    src->value = 4;
+    settle(inf, dbl->out());
+    CHECK(dbl->out()->getState() == PinState_Ready);
+    CHECK(dbl->out()->getError() == nullptr);
+    CHECK(dbl->out()->val() == 8);
+}
+
+static void boundedThreads()
+{
+    ImNodeFlow inf;
+    inf.setBackgroundThreads(2);
+    std::vector<std::shared_ptr<Double>> nodes;
+    for (int i = 0; i < 8; i++)
+        nodes.push_back(inf.addNode<Double>({0, 0}));
+    Double::maxRunning = 0;
+    for (auto& n : nodes)
+        settle(inf, n->out());
+    CHECK(Double::maxRunning > 0 && Double::maxRunning <= 2);
+}
+
+static void outlivesHandler()
+{
+    std::shared_ptr<Double> dbl;
+    {
+        ImNodeFlow inf;
+        dbl = inf.addNode<Double>({0, 0});
+        inf.evaluate();
+        CHECK(dbl->out()->getState() == PinState_Pending);
+    }
+    // Destroying the pin with its job collected by nobody must not touch the handler
+    dbl.reset();
+}
+
+int main()
+{
+    relaunchOnChange();
+    relaunchOnChangedValue();
+    submitFromWorkers();
+    errorState();
+    boundedThreads();
+    outlivesHandler();
+    return test::result();
+}
@@ -0,0 +1,69 @@
+#include "ImNodeFlow.h"
+#include "test.h"
+
+using namespace ImFlow;
+
+class Increment : public BaseNode
+{
+public:
+    Increment()
+    {
+        addIN<int>("in", 0, ConnectionFilter::None());
+        addOUT<int>("out")->behaviour([this]() { return getInVal<int>("in") + 1; });
+    }
+};
+
+static void chainCycles()
+{
+    ImNodeFlow inf;
+    inf.rejectCycles(true);
+    auto a = inf.addNode<Increment>({0, 0});
+    auto b = inf.addNode<Increment>({0, 0});
+    auto c = inf.addNode<Increment>({0, 0});
+    a->outPin("out")->createLink(b->inPin("in"));
+    b->outPin("out")->createLink(c->inPin("in"));
+
+    CHECK(inf.wouldCreateCycle(c->outPin("out"), a->inPin("in")));
+    CHECK(!inf.wouldCreateCycle(a->outPin("out"), c->inPin("in")));
+    c->outPin("out")->createLink(a->inPin("in"));
+    CHECK(!a->inPin("in")->isConnected());
+}
+
+static void replacedLink()
+{
+    ImNodeFlow inf;
+    inf.rejectCycles(true);
+    auto a = inf.addNode<Increment>({0, 0});
+    auto b = inf.addNode<Increment>({0, 0});
+    auto c = inf.addNode<Increment>({0, 0});
+    a->outPin("out")->createLink(b->inPin("in"));
+    b->outPin("out")->createLink(c->inPin("in"));
+
+    // c -> b would replace a -> b, but b still feeds c
+    CHECK(inf.wouldCreateCycle(c->outPin("out"), b->inPin("in")));
+    // a -> c replaces b -> c: no cycle
+    CHECK(!inf.wouldCreateCycle(a->outPin("out"), c->inPin("in")));
+    a->outPin("out")->createLink(c->inPin("in"));
+    CHECK(c->inPin("in")->getLink().lock()->left() == a->outPin("out"));
+}
+
+static void sameNode()
+{
+    ImNodeFlow inf;
+    inf.rejectCycles(true);
+    auto a = inf.addNode<Increment>({0, 0});
+    CHECK(inf.wouldCreateCycle(a->outPin("out"), a->inPin("in")));
+
+    static_cast<InPin<int>*>(a->inPin("in"))->allowSameNodeConnections(true);
+    CHECK(!inf.wouldCreateCycle(a->outPin("out"), a->inPin("in")));
+    a->outPin("out")->createLink(a->inPin("in"));
+    CHECK(a->inPin("in")->isConnected());
+}
+
+int main()
+{
+    chainCycles();
+    replacedLink();
+    sameNode();
+    return test::result();
+}
@@ -0,0 +1,95 @@
+#include "ImNodeFlow.h"
+#include "headless.h"
+#include "test.h"
+
+#include <string>
+
+using namespace ImFlow;
+
+// Nodes showing a thousand dynamic inputs each, a varying subset of them every frame.
+// Pins not shown in a frame are left out of its layout and removed at its end, along with their links.
+
+class Bus : public BaseNode
+{
+public:
+    explicit Bus(int width) :m_width(width)
+    {
+        for (int i = 0; i < width; i++)
+            m_names.push_back("ch" + std::to_string(i));
+        addOUT<int>("sum")->behaviour([this]() { return m_sum; });
+    }
+
+    void draw() override
+    {
+        int sum = 0;
+        for (int i = 0; i < m_width; i += step)
+            sum += showIN_uid<int>(i, m_names[i], 1, ConnectionFilter::None());
+        if (sum != m_sum)
+        {
+            m_sum = sum;
+            markDirty();
+        }
+    }
+
+    int step = 1;
+private:
+    int m_width;
+    int m_sum = 0;
+    std::vector<std::string> m_names;
+};
+
+class Source : public BaseNode
+{
+public:
+    Source() { addOUT<int>("out")->behaviour([]() { return 10; }); }
+};
+
+int main()
+{
+    test::Headless imgui;
+    ImNodeFlow inf("stress");
+    // Side by side within the display, none of them is culled
+    std::vector<std::shared_ptr<Bus>> buses;
+    for (int i = 0; i < 8; i++)
+        buses.push_back(inf.addNode<Bus>({i * 200.f, 0.f}, 1000));
+    auto frame = [&]() { imgui.frame([&]() { inf.update(); }); };
+
+    frame();
+    for (auto& b : buses)
+        CHECK(b->getDynamicIns().size() == 1000);
+
+    // Every other channel: the hidden pins go, the shown ones are kept as they were
+    Pin* kept = buses[0]->getDynamicIns()[2].second.get();
+    auto src = inf.addNode<Source>({0.f, -200.f});
+    src->outPin("out")->createLink(buses[0]->getDynamicIns()[1].second.get());
+    src->outPin("out")->createLink(kept);
+    for (auto& b : buses)
+        b->step = 2;
+    frame();
+    for (auto& b : buses)
+        CHECK(b->getDynamicIns().size() == 500);
+    CHECK(buses[0]->getDynamicIns()[1].second.get() == kept);
+    CHECK(kept->isConnected());
+    int links = 0;
+    for (auto& l : inf.getLinks())
+        links += !l.expired();
+    CHECK(links == 1);
+
+    // Shown again, recreated unconnected
+    for (auto& b : buses)
+        b->step = 1;
+    frame();
+    for (auto& b : buses)
+        CHECK(b->getDynamicIns().size() == 1000);
+    for (auto& p : buses[0]->getDynamicIns())
+        if (p.second->getUid() == std::hash<int>{}(1))
+            CHECK(!p.second->isConnected());
+
+    // Steady frames, then the values reach the output
+    for (int i = 0; i < 10; i++)
+        frame();
+    inf.evaluate();
+    CHECK(static_cast<OutPin<int>*>(buses[0]->outPin("sum"))->val() == 999 + 10);
+    CHECK(static_cast<OutPin<int>*>(buses[1]->outPin("sum"))->val() == 1000);
+    return test::result();
+}
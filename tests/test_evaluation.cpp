@@ -0,0 +1,101 @@
+#include "ImNodeFlow.h"
+#include "test.h"
+
+using namespace ImFlow;
+
+// Adds one to its input, counting the evaluations
+class Increment : public BaseNode
+{
+public:
+    int calls = 0;
+
+    Increment()
+    {
+        addIN<int>("in", 0, ConnectionFilter::None());
+        addOUT<int>("out")->behaviour([this]() { calls++; return getInVal<int>("in") + 1; });
+    }
+
+    int out() { return static_cast<OutPin<int>*>(outPin("out"))->val(); }
+};
+
+static void chain()
+{
+    ImNodeFlow inf;
+    auto a = inf.addNode<Increment>({0, 0});
+    auto b = inf.addNode<Increment>({0, 0});
+    auto c = inf.addNode<Increment>({0, 0});
+    a->outPin("out")->createLink(b->inPin("in"));
+    b->outPin("out")->createLink(c->inPin("in"));
+
+    uint64_t epoch = inf.getEvaluationEpoch();
+    inf.evaluate();
+    CHECK(inf.getEvaluationEpoch() > epoch);
+    CHECK(c->out() == 3);
+    // Pulling again in the same epoch reuses the values
+    CHECK(a->calls == 1 && b->calls == 1 && c->calls == 1);
+
+    inf.evaluate();
+    CHECK(a->calls == 2 && b->calls == 2 && c->calls == 2);
+}
+
+static void sinks()
+{
+    ImNodeFlow inf;
+    auto a = inf.addNode<Increment>({0, 0});
+    auto b = inf.addNode<Increment>({0, 0});
+    auto other = inf.addNode<Increment>({0, 0});
+    a->outPin("out")->createLink(b->inPin("in"));
+
+    // Only what the sink depends on is evaluated
+    inf.evaluate({b->outPin("out")});
+    CHECK(a->calls == 1 && b->calls == 1);
+    CHECK(other->calls == 0);
+}
+
+static void cycle()
+{
+    ImNodeFlow inf;
+    auto a = inf.addNode<Increment>({0, 0});
+    auto b = inf.addNode<Increment>({0, 0});
+    a->outPin("out")->createLink(b->inPin("in"));
+    b->outPin("out")->createLink(a->inPin("in"));
+
+    // The cycle is broken by the epoch: each behaviour runs once and reads the cached value on the way back
+    inf.evaluate();
+    CHECK(a->calls == 1 && b->calls == 1);
+    inf.evaluate();
+    CHECK(a->calls == 2 && b->calls == 2);
+}
+
+static void noContext()
+{
+    // Batch use: no ImGui context is ever created
+    CHECK(ImGui::GetCurrentContext() == nullptr);
+    ImNodeFlow inf;
+    std::vector<std::shared_ptr<Increment>> nodes;
+    for (int i = 0; i < 10; i++)
+    {
+        nodes.push_back(inf.addNode<Increment>({0, 0}));
+        nodes.back()->setThreadSafe(true);
+        if (i > 0)
+            nodes[i - 1]->outPin("out")->createLink(nodes[i]->inPin("in"));
+    }
+
+    inf.evaluate();
+    CHECK(nodes.back()->out() == 10);
+    inf.evaluate({nodes[4]->outPin("out")});
+    CHECK(nodes[4]->out() == 5);
+    inf.evaluateParallel();
+    CHECK(nodes.back()->out() == 10);
+    CHECK(nodes[0]->calls == 3);
+    CHECK(ImGui::GetCurrentContext() == nullptr);
+}
+
+int main()
+{
+    chain();
+    sinks();
+    cycle();
+    noContext();
+    return test::result();
+}
@@ -0,0 +1,108 @@
+#include "ImNodeFlow.h"
+#include "test.h"
+
+using namespace ImFlow;
+
+// Pin handles resolving to the right pin, or to nothing, after pins are dropped, re-added or made dynamic.
+
+class Inputs : public BaseNode
+{
+public:
+    Inputs()
+    {
+        a = addIN<int>("a", 1, ConnectionFilter::None());
+        b = addIN<int>("b", 2, ConnectionFilter::None());
+        c = addIN<int>("c", 3, ConnectionFilter::None());
+        out = addOUT<int>("out");
+        out2 = addOUT<int>("out2");
+    }
+
+    InPinHandle<int> a, b, c;
+    OutPinHandle<int> out, out2;
+};
+
+class Single : public BaseNode
+{
+public:
+    Single() { a = addIN<int>("a", 1, ConnectionFilter::None()); }
+
+    InPinHandle<int> a;
+};
+
+static bool throws(const std::function<void()>& f)
+{
+    try { f(); }
+    catch (const std::out_of_range&) { return true; }
+    return false;
+}
+
+static void resolve()
+{
+    ImNodeFlow inf;
+    auto n = inf.addNode<Inputs>({0, 0});
+    CHECK(n->a.valid() && n->b.index() == 1 && n->c.index() == 2);
+    CHECK(n->inPin(n->b) == n->inPin("b"));
+    CHECK(n->outPin(n->out2) == n->outPin("out2"));
+    CHECK(n->getInVal(n->c) == 3);
+}
+
+static void invalid()
+{
+    ImNodeFlow inf;
+    auto n = inf.addNode<Inputs>({0, 0});
+    InPinHandle<int> none;
+    CHECK(!none.valid());
+    CHECK(n->inPin(none) == nullptr);
+    CHECK(throws([&]() { n->getInVal(none); }));
+
+    // Dynamic pins aren't in the static lists
+    n->showIN<int>("dyn", 4, ConnectionFilter::None());
+    auto dyn = std::static_pointer_cast<InPin<int>>(n->getDynamicIns().back().second);
+    InPinHandle<int> h(dyn);
+    CHECK(!h.valid());
+    CHECK(n->inPin(h) == nullptr);
+    CHECK(throws([&]() { n->getInVal(h); }));
+}
+
+static void dropped()
+{
+    ImNodeFlow inf;
+    auto n = inf.addNode<Inputs>({0, 0});
+
+    // "c" moves to the position of "b"
+    n->dropIN("b");
+    CHECK(n->inPin(n->b) == nullptr);
+    CHECK(throws([&]() { n->getInVal(n->b); }));
+    CHECK(n->inPin(n->c) == n->inPin("c"));
+    CHECK(n->getInVal(n->c) == 3);
+    CHECK(n->getInVal(n->a) == 1);
+
+    // Added again with another type
+    n->dropIN("a");
+    n->addIN<float>("a", 5.f, ConnectionFilter::None());
+    CHECK(n->inPin(n->a) == nullptr);
+    CHECK(throws([&]() { n->getInVal(n->a); }));
+}
+
+static void sameIndex()
+{
+    ImNodeFlow inf;
+    auto n = inf.addNode<Single>({0, 0});
+
+    // Same index and UID as the dropped pin, only the type differs
+    n->dropIN("a");
+    auto f = n->addIN<float>("a", 5.f, ConnectionFilter::None());
+    CHECK(InPinHandle<float>(f).index() == n->a.index());
+    CHECK(n->inPin(n->a) == nullptr);
+    CHECK(throws([&]() { n->getInVal(n->a); }));
+    CHECK(n->getInVal(InPinHandle<float>(f)) == 5.f);
+}
+
+int main()
+{
+    resolve();
+    invalid();
+    dropped();
+    sameIndex();
+    return test::result();
+}
@@ -0,0 +1,97 @@
+#include "ImNodeFlow.h"
+#include "test.h"
+
+using namespace ImFlow;
+
+class Source : public BaseNode
+{
+public:
+    int value = 1, calls = 0;
+
+    Source() { addOUT<int>("out")->behaviour([this]() { calls++; return value; }); }
+};
+
+// Only reads its input when enabled
+class Conditional : public BaseNode
+{
+public:
+    bool enabled = false;
+    int calls = 0;
+
+    Conditional()
+    {
+        addIN<int>("in", 0, ConnectionFilter::None());
+        addOUT<int>("out")->behaviour([this]() { calls++; return enabled ? getInVal<int>("in") : -1; });
+    }
+
+    int out() { return static_cast<OutPin<int>*>(outPin("out"))->val(); }
+};
+
+static void cachedUntilDirty()
+{
+    ImNodeFlow inf;
+    inf.incrementalEvaluation(true);
+    auto src = inf.addNode<Source>({0, 0});
+    auto dst = inf.addNode<Conditional>({0, 0});
+    dst->enabled = true;
+    src->outPin("out")->createLink(dst->inPin("in"));
+
+    inf.evaluate();
+    CHECK(dst->out() == 1);
+    inf.evaluate();
+    CHECK(src->calls == 1 && dst->calls == 1);
+
+    src->value = 2;
+    src->markDirty();
+    inf.evaluate();
+    CHECK(dst->out() == 2);
+    CHECK(src->calls == 2 && dst->calls == 2);
+}
+
+static void dirtyUpstreamNotPulled()
+{
+    ImNodeFlow inf;
+    inf.incrementalEvaluation(true);
+    auto src = inf.addNode<Source>({0, 0});
+    auto dst = inf.addNode<Conditional>({0, 0});
+    src->outPin("out")->createLink(dst->inPin("in"));
+
+    // Evaluated without pulling the source, which stays dirty
+    CHECK(dst->out() == -1);
+    CHECK(src->calls == 0);
+
+    // Repeated marks with nothing evaluated in between stop at the source
+    src->markDirty();
+    src->markDirty();
+    CHECK(static_cast<OutPin<int>*>(dst->outPin("out"))->isDirty());
+    CHECK(dst->out() == -1);
+
+    // Marking the (already dirty) source must still reach the node downstream
+    dst->enabled = true;
+    src->value = 5;
+    src->markDirty();
+    CHECK(dst->out() == 5);
+}
+
+static void cycleTerminates()
+{
+    ImNodeFlow inf;
+    inf.incrementalEvaluation(true);
+    auto a = inf.addNode<Conditional>({0, 0});
+    auto b = inf.addNode<Conditional>({0, 0});
+    a->outPin("out")->createLink(b->inPin("in"));
+    b->outPin("out")->createLink(a->inPin("in"));
+
+    inf.evaluate();
+    a->markDirty();
+    CHECK(static_cast<OutPin<int>*>(a->outPin("out"))->isDirty());
+    CHECK(static_cast<OutPin<int>*>(b->outPin("out"))->isDirty());
+}
+
+int main()
+{
+    cachedUntilDirty();
+    dirtyUpstreamNotPulled();
+    cycleTerminates();
+    return test::result();
+}
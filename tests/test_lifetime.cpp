@@ -0,0 +1,85 @@
+#include "ImNodeFlow.h"
+#include "test.h"
+
+using namespace ImFlow;
+
+// Nodes and links kept alive by the application after their handler is gone or cleared.
+// Failures show up as crashes, or as reports when built with sanitizers.
+
+class Increment : public BaseNode
+{
+public:
+    Increment()
+    {
+        addIN<int>("in", 0, ConnectionFilter::None());
+        addOUT<int>("out")->behaviour([this]() { return getInVal<int>("in") + 1; });
+    }
+};
+
+static void outliveHandler()
+{
+    std::shared_ptr<Increment> a, b, c;
+    {
+        ImNodeFlow inf;
+        a = inf.addNode<Increment>({0, 0});
+        b = inf.addNode<Increment>({0, 0});
+        c = inf.addNode<Increment>({0, 0});
+        a->outPin("out")->createLink(b->inPin("in"));
+        b->outPin("out")->createLink(c->inPin("in"));
+    }
+    CHECK(a->getHandler() == nullptr);
+
+    // Unlinking, then releasing an output with links still attached
+    c->inPin("in")->deleteLink();
+    CHECK(!c->inPin("in")->isConnected());
+    a.reset();
+    CHECK(!b->inPin("in")->isConnected());
+    b.reset();
+    c.reset();
+}
+
+static void outliveClear()
+{
+    ImNodeFlow inf;
+    auto a = inf.addNode<Increment>({0, 0});
+    auto b = inf.addNode<Increment>({0, 0});
+    a->outPin("out")->createLink(b->inPin("in"));
+    inf.clear();
+    CHECK(inf.getNodesCount() == 0);
+
+    // The handler is still usable while the old nodes are alive
+    auto c = inf.addNode<Increment>({0, 0});
+    auto d = inf.addNode<Increment>({0, 0});
+    c->outPin("out")->createLink(d->inPin("in"));
+    b.reset();
+    a.reset();
+    inf.evaluate();
+    CHECK(static_cast<OutPin<int>*>(d->outPin("out"))->val() == 2);
+}
+
+static void removeNode()
+{
+    ImNodeFlow inf;
+    auto a = inf.addNode<Increment>({0, 0});
+    NodeUID uid = inf.addNode<Increment>({0, 0})->getUID();
+    auto c = inf.addNode<Increment>({0, 0});
+    a->outPin("out")->createLink(inf.getNode(uid)->inPin("in"));
+    inf.getNode(uid)->outPin("out")->createLink(c->inPin("in"));
+
+    CHECK(inf.removeNode(uid));
+    CHECK(!inf.removeNode(uid));
+    CHECK(inf.getNode(uid) == nullptr);
+    CHECK(inf.getNodesCount() == 2);
+    CHECK(inf.getZOrder().size() == 2);
+    CHECK(!c->inPin("in")->isConnected());
+    inf.evaluate();
+    CHECK(static_cast<OutPin<int>*>(c->outPin("out"))->val() == 1);
+}
+
+int main()
+{
+    outliveHandler();
+    outliveClear();
+    removeNode();
+    return test::result();
+}
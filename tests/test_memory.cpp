@@ -0,0 +1,123 @@
+#include "ImNodeFlow.h"
+#include "test.h"
+
+using namespace ImFlow;
+
+// Allocations of a graph built and torn down in a pool, as seen by the counters of the resource,
+// and the styles shared by its nodes and pins.
+
+class Increment : public BaseNode
+{
+public:
+    Increment()
+    {
+        addIN<int>("in", 0, ConnectionFilter::None());
+        addOUT<int>("out")->behaviour([this]() { return getInVal<int>("in") + 1; });
+    }
+};
+
+static void buildChain(ImNodeFlow& inf, int n)
+{
+    std::shared_ptr<Increment> prev = inf.addNode<Increment>({0, 0});
+    for (int i = 1; i < n; i++)
+    {
+        auto node = inf.addNode<Increment>({0, 0});
+        prev->outPin("out")->createLink(node->inPin("in"));
+        prev = node;
+    }
+}
+
+static void balanced(const MemoryResource& pool)
+{
+    for (int k = 0; k < MemoryKind_COUNT; k++)
+    {
+        MemoryCounters c = pool.counters((MemoryKind)k);
+        CHECK(c.allocations == c.deallocations);
+        CHECK(c.bytes == 0);
+    }
+    CHECK(pool.live() == 0);
+}
+
+static void clearGraph()
+{
+    auto pool = std::make_shared<PoolResource>();
+    ImNodeFlow inf;
+    inf.setMemoryResource(pool);
+    buildChain(inf, 100);
+
+    CHECK(pool->counters(MemoryKind_Node).allocations == 100);
+    CHECK(pool->counters(MemoryKind_Node).bytes > 0);
+    CHECK(pool->counters(MemoryKind_Pin).allocations >= 200);
+    CHECK(pool->counters(MemoryKind_Link).allocations == 99);
+    CHECK(inf.memoryReport().nodes == pool->counters(MemoryKind_Node).bytes);
+
+    inf.clear();
+    balanced(*pool);
+
+    // Freed blocks and released chunks are both reused
+    buildChain(inf, 100);
+    CHECK(pool->counters(MemoryKind_Node).allocations == 200);
+    CHECK(pool->live() > 0);
+}
+
+static void destroyHandler()
+{
+    auto pool = std::make_shared<PoolResource>();
+    {
+        ImNodeFlow inf;
+        inf.setMemoryResource(pool);
+        buildChain(inf, 100);
+        CHECK(pool->live() > 0);
+    }
+    balanced(*pool);
+}
+
+static void smallChunks()
+{
+    // Chunks smaller than the largest pooled block are enlarged
+    PoolResource pool(16);
+    void* a = pool.allocate(1024, 16, MemoryKind_Node);
+    void* b = pool.allocate(1024, 16, MemoryKind_Node);
+    std::memset(a, 1, 1024);
+    std::memset(b, 2, 1024);
+    CHECK(static_cast<unsigned char*>(a)[1023] == 1);
+    pool.deallocate(a, 1024, 16, MemoryKind_Node);
+    pool.deallocate(b, 1024, 16, MemoryKind_Node);
+    balanced(pool);
+}
+
+static void styles()
+{
+    ImNodeFlow inf;
+    buildChain(inf, 10);
+    // Nodes and pins without a style share the default ones
+    CHECK(inf.memoryReport().styleCount == 2);
+
+    // Pre-built styles are interned, the defaults are the cyan ones
+    CHECK(NodeStyle::brown() == NodeStyle::brown());
+    CHECK(NodeStyle::cyan() == inf.getNodes()[0]->getStyle());
+    CHECK(PinStyle::cyan() == inf.getNodes()[0]->getIns()[0]->getStyle());
+
+    // Editing copies the style of that node only
+    auto& first = *inf.getNodes()[0];
+    first.editStyle().radius = 20.f;
+    CHECK(first.getStyle()->radius == 20.f);
+    CHECK(inf.getNodes()[1]->getStyle()->radius == NodeStyle::cyan()->radius);
+    CHECK(NodeStyle::cyan()->radius != 20.f);
+    CHECK(inf.memoryReport().styleCount == 3);
+    // Later edits reuse the copy
+    const NodeStyle* copy = first.getStyle().get();
+    first.editStyle().radius = 30.f;
+    CHECK(first.getStyle().get() == copy);
+    first.setStyle(NodeStyle::cyan());
+    CHECK(inf.memoryReport().styleCount == 2);
+}
+
+int main()
+{
+    clearGraph();
+    destroyHandler();
+    smallChunks();
+    styles();
+    return test::result();
+}
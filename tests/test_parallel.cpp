@@ -0,0 +1,89 @@
+#include "ImNodeFlow.h"
+#include "test.h"
+
+#include <stdexcept>
+
+using namespace ImFlow;
+
+// Adds one to its input, throwing when asked to
+class Increment : public BaseNode
+{
+public:
+    bool fail = false;
+
+    Increment()
+    {
+        setThreadSafe(true);
+        addIN<int>("in", 0, ConnectionFilter::None());
+        addOUT<int>("out")->behaviour([this]() {
+            if (fail)
+                throw std::runtime_error("failed");
+            return getInVal<int>("in") + 1;
+        });
+    }
+
+    int out() { return static_cast<OutPin<int>*>(outPin("out"))->val(); }
+};
+
+// Builds "chains" independent chains of "length" nodes, returns the last node of each
+static std::vector<std::shared_ptr<Increment>> chains(ImNodeFlow& inf, int count, int length)
+{
+    std::vector<std::shared_ptr<Increment>> ends;
+    for (int c = 0; c < count; c++)
+    {
+        auto prev = inf.addNode<Increment>({0, 0});
+        for (int i = 1; i < length; i++)
+        {
+            auto node = inf.addNode<Increment>({0, 0});
+            prev->outPin("out")->createLink(node->inPin("in"));
+            prev = node;
+        }
+        ends.push_back(prev);
+    }
+    return ends;
+}
+
+static void sameAsSerial()
+{
+    ImNodeFlow inf;
+    inf.setEvaluationThreads(4);
+    auto ends = chains(inf, 16, 32);
+    for (int run = 0; run < 20; run++)
+    {
+        inf.evaluateParallel();
+        for (auto& e : ends)
+            CHECK(e->out() == 32);
+    }
+}
+
+static void exceptionRethrown()
+{
+    ImNodeFlow inf;
+    inf.setEvaluationThreads(4);
+    auto ends = chains(inf, 16, 32);
+    ends[5]->fail = true;
+
+    bool thrown = false;
+    try
+    {
+        inf.evaluateParallel();
+    }
+    catch (const std::runtime_error&)
+    {
+        thrown = true;
+    }
+    CHECK(thrown);
+
+    // The pool is still usable and the failed pin is evaluated again
+    ends[5]->fail = false;
+    inf.evaluateParallel();
+    for (auto& e : ends)
+        CHECK(e->out() == 32);
+}
+
+int main()
+{
+    sameAsSerial();
+    exceptionRethrown();
+    return test::result();
+}
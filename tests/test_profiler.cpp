@@ -0,0 +1,44 @@
+#include "ImNodeFlow.h"
+#include "test.h"
+
+using namespace ImFlow;
+
+class Source : public BaseNode
+{
+public:
+    Source() { addOUT<int>("out")->behaviour([]() { return 1; }); }
+};
+
+// Runs "evaluations" evaluations, then starts a new profiler frame
+static void frame(ImNodeFlow& inf, int evaluations)
+{
+    for (int i = 0; i < evaluations; i++)
+        inf.evaluate();
+    inf.profilerNextFrame();
+}
+
+static void averageWindow()
+{
+    ImNodeFlow inf;
+    inf.enableProfiler(true, 4);
+    auto node = inf.addNode<Source>({0, 0});
+
+    // Only the last 4 completed frames count: 5, 1, 1, 1
+    for (int evaluations : {9, 9, 5, 1, 1, 1})
+        frame(inf, evaluations);
+    CHECK(node->getProfile(1).calls == 1);
+    CHECK(node->getProfile(4).calls == 5);
+    CHECK(node->getProfile(5).frame == 0);
+    CHECK(node->getProfileAverage().calls == 2);
+
+    // The frame being recorded isn't averaged
+    inf.evaluate();
+    CHECK(node->getProfile(0).calls == 1);
+    CHECK(node->getProfileAverage().calls == 2);
+}
+
+int main()
+{
+    averageWindow();
+    return test::result();
+}
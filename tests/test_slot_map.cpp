@@ -0,0 +1,50 @@
+#include "ImNodeFlow.h"
+#include "test.h"
+
+// Handles of the node storage: stale, forged and reused slots.
+
+using Map = SlotMap<std::shared_ptr<int>>;
+
+static Map::Handle forge(uint32_t slot, uint32_t generation) { return ((Map::Handle)generation << 32) | slot; }
+
+static void stale()
+{
+    Map map;
+    Map::Handle a = map.insert(std::make_shared<int>(1));
+    Map::Handle b = map.insert(std::make_shared<int>(2));
+    CHECK(a != 0 && b != 0 && a != b);
+    CHECK(map.erase(a));
+    CHECK(!map.contains(a));
+    CHECK(!map.erase(a));
+    CHECK(**map.get(b) == 2);
+
+    // The freed slot is reused with a new generation
+    Map::Handle c = map.insert(std::make_shared<int>(3));
+    CHECK((uint32_t)c == (uint32_t)a && c != a);
+    CHECK(map.get(a) == nullptr);
+    CHECK(**map.get(c) == 3);
+}
+
+static void forgedFree()
+{
+    Map map;
+    Map::Handle a = map.insert(std::make_shared<int>(1));
+    map.insert(std::make_shared<int>(2));
+    map.erase(a);
+    // Only the last value is left, the freed slot points past it. No generation of the free slot resolves
+    for (uint32_t g = 0; g < 8; g++)
+    {
+        CHECK(map.get(forge((uint32_t)a, g)) == nullptr);
+        CHECK(!map.contains(forge((uint32_t)a, g)));
+        CHECK(!map.erase(forge((uint32_t)a, g)));
+    }
+    CHECK(map.size() == 1);
+    CHECK(map.get(forge(5, 1)) == nullptr);
+}
+
+int main()
+{
+    stale();
+    forgedFree();
+    return test::result();
+}
@@ -0,0 +1,91 @@
+#include "ImNodeFlow.h"
+#include "test.h"
+
+using namespace ImFlow;
+
+static Stream<float> ramp(size_t n, float start)
+{
+    Stream<float> s(n);
+    float* d = s.mutableData();
+    for (size_t i = 0; i < n; i++)
+        d[i] = start + (float)i;
+    return s;
+}
+
+class Ramp : public BaseNode
+{
+public:
+    Stream<float> data = ramp(1000, 0.f);
+
+    Ramp() { addOUT<Stream<float>>("out")->behaviour([this]() { return data; }); }
+};
+
+class Add : public BaseNode
+{
+public:
+    Add()
+    {
+        addIN<Stream<float>>("A", Stream<float>(), ConnectionFilter::None());
+        addIN<Stream<float>>("B", Stream<float>(), ConnectionFilter::None());
+        addOUT<Stream<float>>("out")->behaviour([this]() {
+            return StreamKernels::add(getInVal<Stream<float>>("A"), getInVal<Stream<float>>("B"));
+        });
+    }
+};
+
+static void kernels()
+{
+    // Odd size, so the scalar tail runs too
+    const size_t n = 1003;
+    Stream<float> a = ramp(n, 1.f), b = ramp(n, 2.f);
+    Stream<float> sum = StreamKernels::add(a, b);
+    Stream<float> diff = StreamKernels::sub(b, a);
+    Stream<float> prod = StreamKernels::mul(a, b);
+    Stream<float> affine = StreamKernels::scaleAdd(a, 2.f, 1.f);
+    bool ok = true;
+    for (size_t i = 0; i < n; i++)
+        ok &= sum[i] == a[i] + b[i] && diff[i] == 1.f && prod[i] == a[i] * b[i] && affine[i] == a[i] * 2.f + 1.f;
+    CHECK(ok);
+    CHECK(StreamKernels::sum(ramp(100, 0.f)) == 4950.f);
+    CHECK(StreamKernels::add(a, ramp(10, 0.f)).size() == 10);
+    CHECK((reinterpret_cast<uintptr_t>(a.data()) % Stream<float>::Alignment) == 0);
+}
+
+static void slices()
+{
+    Stream<float> a = ramp(100, 0.f);
+    Stream<float> s = a.slice(10, 20);
+    CHECK(s.size() == 20 && s.data() == a.data() + 10 && s[0] == 10.f);
+    CHECK(a.slice(90).size() == 10);
+    CHECK(a.slice(200).empty());
+
+    // A slice keeps the buffer alive
+    const float* data = a.data();
+    a = Stream<float>();
+    CHECK(s.data() == data + 10 && s[19] == 29.f);
+}
+
+static void zeroCopy()
+{
+    ImNodeFlow inf;
+    auto src = inf.addNode<Ramp>({0, 0});
+    auto add = inf.addNode<Add>({0, 0});
+    src->outPin("out")->createLink(add->inPin("A"));
+    src->outPin("out")->createLink(add->inPin("B"));
+    inf.evaluate();
+
+    // Both inputs read the producer's buffer itself
+    const Stream<float>& out = static_cast<OutPin<Stream<float>>*>(src->outPin("out"))->val();
+    CHECK(out.data() == src->data.data());
+    CHECK(add->getInVal<Stream<float>>("A").data() == out.data());
+    const Stream<float>& sum = static_cast<OutPin<Stream<float>>*>(add->outPin("out"))->val();
+    CHECK(sum.size() == 1000 && sum[999] == 1998.f);
+}
+
+int main()
+{
+    kernels();
+    slices();
+    zeroCopy();
+    return test::result();
+}
@@ -0,0 +1,50 @@
+#include "ImNodeFlow.h"
+#include "test.h"
+
+// The vectorized vertex transform and index rebase against plain loops, with counts leaving a scalar tail
+
+static void vertices()
+{
+    for (int count : {0, 1, 3, 4, 7, 1001})
+    {
+        std::vector<ImDrawVert> src(count), dst(count);
+        for (int i = 0; i < count; i++)
+        {
+            src[i].pos = ImVec2((float)i, (float)-i * 0.5f);
+            src[i].uv = ImVec2((float)i / 7.f, 1.f - (float)i / 3.f);
+            src[i].col = 0x01020304u * (ImU32)(i + 1);
+        }
+        ImVec2 origin(12.5f, -3.f);
+        TransformVertices(src.data(), dst.data(), count, origin, 0.75f);
+        bool ok = true;
+        for (int i = 0; i < count; i++)
+        {
+            ImVec2 p = src[i].pos * 0.75f + origin;
+            ok &= dst[i].pos.x == p.x && dst[i].pos.y == p.y;
+            ok &= std::memcmp(&dst[i].uv, &src[i].uv, sizeof(ImVec2)) == 0 && dst[i].col == src[i].col;
+        }
+        CHECK(ok);
+    }
+}
+
+static void indices()
+{
+    for (int count : {0, 5, 8, 13, 1001})
+    {
+        std::vector<ImDrawIdx> src(count), dst(count);
+        for (int i = 0; i < count; i++)
+            src[i] = (ImDrawIdx)(i * 3);
+        RebaseIndices(src.data(), dst.data(), count, 100);
+        bool ok = true;
+        for (int i = 0; i < count; i++)
+            ok &= dst[i] == (ImDrawIdx)(src[i] + 100);
+        CHECK(ok);
+    }
+}
+
+int main()
+{
+    vertices();
+    indices();
+    return test::result();
+}